@@ -0,0 +1,104 @@
+#ifndef EDGE_STORAGE_H
+#define EDGE_STORAGE_H
+
+#include <vector>
+#include <new>
+#include <type_traits>
+
+//payload of one edge: small trivially copyable types are kept inline, others on the heap
+//it is a plain value like a raw pointer, so the owner calls create/copy/destroy itself
+template <class T, bool isInline = std::is_trivially_copyable<T>::value && sizeof(T)<=sizeof(T*)>
+struct EdgePayload;
+
+template <class T>
+struct EdgePayload<T, true>
+{
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage; //the value itself (no default constructor needed)
+
+    void create(const T &data) {new (&storage) T(data);}
+    void copy() {} //memberwise copy is already independent
+    void destroy() {}
+    T& get() {return *reinterpret_cast<T*>(&storage);}
+    const T& get() const {return *reinterpret_cast<const T*>(&storage);}
+};
+
+template <class T>
+struct EdgePayload<T, false>
+{
+    T *pointer;
+
+    void create(const T &data) {pointer = new T(data);}
+    void copy() {pointer = new T(*pointer);} //makes memberwise copy independent of the original
+    void destroy() {delete pointer;}
+    T& get() {return *pointer;}
+    const T& get() const {return *pointer;}
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+// bit rows (presence of matrix cells)
+
+typedef std::vector<unsigned long long> BitRow;
+
+inline unsigned lowestBit(unsigned long long word) //index of the lowest set bit (word!=0)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    unsigned res = 0;
+    while(!(word&1)) {word >>= 1; res++;}
+    return res;
+#endif
+}
+
+inline unsigned bitCount(unsigned long long word) //number of set bits
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    unsigned res = 0;
+    for(; word; word &= word-1) res++;
+    return res;
+#endif
+}
+
+inline bool testBit(const BitRow &bits, unsigned i)
+{
+    return bits[i>>6]>>(i&63)&1;
+}
+
+inline void setBit(BitRow &bits, unsigned i)
+{
+    bits[i>>6] |= 1ull<<(i&63);
+}
+
+inline void resetBit(BitRow &bits, unsigned i)
+{
+    bits[i>>6] &= ~(1ull<<(i&63));
+}
+
+inline void eraseBit(BitRow &bits, unsigned i) //removes bit i, all next bits are shifted down by one
+{
+    unsigned word = i>>6;
+    unsigned long long low = bits[word]&((1ull<<(i&63))-1);
+    unsigned long long high = (i&63)==63 ? 0 : bits[word]>>((i&63)+1)<<(i&63);
+    bits[word] = low|high;
+    for(unsigned w=word+1; w<bits.size(); w++)
+    {
+        bits[w-1] |= bits[w]<<63;
+        bits[w] >>= 1;
+    }
+}
+
+template <class Function>
+void forEachBit(const BitRow &bits, const Function &function) //calls function(i) for every set bit in increasing order
+{
+    for(unsigned w=0; w<bits.size(); w++)
+    {
+        for(unsigned long long word = bits[w]; word; word &= word-1)
+        {
+            function(w<<6|lowestBit(word));
+        }
+    }
+}
+
+#endif
\ No newline at end of file
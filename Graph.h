@@ -6,8 +6,16 @@
 #include <string>
 #include <random>
 #include <cassert>
-#include <stack>
-#include <queue>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <cstring>
+#include "GraphAlgorithms.h"
+#include "VertexStore.h"
+#include "EdgeStorage.h"
 
 std::random_device rd;
 std::mt19937 mt(rd());
@@ -18,24 +26,74 @@ template <class T_vertices, class T_edges>
 class MatrixGraph;
 template <class T_vertices, class T_edges>
 class ListGraph;
+template <class T_vertices, class T_edges>
+class AdaptiveGraph;
+template <class T_vertices, class T_edges>
+class ListGraphSnapshot;
+template <class T_vertices, class T_edges>
+class ConcurrentListGraph;
+template <class T_vertices, class T_edges>
+class GraphJournal;
+class CompressedGraph;
 
 template <class T_vertices, class T_edges>
 std::ostream& operator <<(std::ostream &ofs, const Graph<T_vertices, T_edges> &graph);
 
 //---------------------------------------------------------------------------------------------------------------//
 
+struct QueryCacheStats
+{
+    unsigned long long hits;
+    unsigned long long misses;
+};
+
+class QueryCache //memoized query results of one graph, valid for a single version of it
+{
+private:
+    enum Flag {strong, weak, flagsN};
+    std::atomic<unsigned> capacity{0}; //max number of stored paths (0 - cache is disabled)
+    unsigned long long version = 0; //version of the graph the stored results belong to
+    signed char flags[flagsN] = {-1, -1}; //connectivity results (-1 - unknown)
+    std::list<std::pair<unsigned long long, std::vector<unsigned>>> paths; //most recently used first
+    std::unordered_map<unsigned long long, std::list<std::pair<unsigned long long, std::vector<unsigned>>>::iterator> index;
+    QueryCacheStats stats{0, 0};
+    mutable std::mutex mutex;
+
+    void sync(unsigned long long graphVersion); //drops results of other versions
+    bool findFlag(unsigned long long graphVersion, Flag flag, bool &res);
+    void storeFlag(unsigned long long graphVersion, Flag flag, bool value);
+public:
+    void setCapacity(unsigned newCapacity); //sets max number of stored paths (0 disables the cache)
+    QueryCacheStats getStats() const; //returns hit/miss counters
+    bool enabled() const {return capacity>0;} //checks if results are stored at all
+    bool findPath(unsigned long long graphVersion, unsigned from, unsigned to, std::vector<unsigned> &res);
+    void storePath(unsigned long long graphVersion, unsigned from, unsigned to, const std::vector<unsigned> &path);
+    bool findStrongly(unsigned long long graphVersion, bool &res) {return findFlag(graphVersion, strong, res);}
+    void storeStrongly(unsigned long long graphVersion, bool value) {storeFlag(graphVersion, strong, value);}
+    bool findWeakly(unsigned long long graphVersion, bool &res) {return findFlag(graphVersion, weak, res);}
+    void storeWeakly(unsigned long long graphVersion, bool value) {storeFlag(graphVersion, weak, value);}
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+
 template <class T_vertices, class T_edges>
 class Graph
 {
 public:
     virtual ~Graph() = 0;
-    void clear(); //cleans the graph
+    virtual void clear(); //cleans the graph
     void randomGraph(unsigned minVertices, unsigned maxVertices, double edgeProb, const T_vertices &verticesData, const T_edges &edgesData);
         //fill graph with random number of vertices and random edges
     unsigned getPathLength(unsigned from, unsigned to) const; //returns number of edges between 2 vertices (or 0, if disconnected)
     Graph<T_vertices, T_edges>& operator=(const Graph<T_vertices, T_edges> &toCopy); //copy
     friend std::ostream& operator << <>(std::ostream &ofs, const Graph<T_vertices, T_edges> &graph);
+    void enableCache(unsigned capacity); //memoize connectivity and up to capacity recent paths
+    void disableCache(); //stop memoizing and drop stored results
+    QueryCacheStats cacheStats() const; //returns cache hit/miss counters
 protected:
+    unsigned long long version = 0; //bumped by every change of the structure
+    mutable QueryCache cache; //opt-in memoization of query results
+
     virtual void addVertex(const T_vertices &data) = 0; //add a new vertex
     virtual void delVertex(unsigned vertex) = 0; //delete a vertex
     virtual void addEdge(unsigned from, unsigned to, const T_edges &data) = 0; //add a new edge
@@ -47,6 +105,7 @@ protected:
     virtual bool stronglyConnected() const = 0; //checks if the graph is strongly connected
     virtual bool weaklyConnected() const = 0; //checks if the graph is weakly connected
     virtual std::vector<unsigned> getPathVertices(unsigned from, unsigned to) const = 0; //returns vertices chain between 2 vertices [from-->to]
+    virtual std::vector<unsigned> stronglyConnectedComponents() const = 0; //returns component id of every vertex
     virtual T_vertices& operator()(unsigned vertex) = 0; //get a reference to vertex
     virtual const T_vertices& operator()(unsigned vertex) const = 0; //get a const reference to vertex
     virtual T_edges& operator()(unsigned from, unsigned to) = 0; //get a reference to edge
@@ -54,21 +113,22 @@ protected:
 };
 
 template <class T_vertices, class T_edges>
-class MatrixGraph : public Graph<T_vertices, T_edges>
+class MatrixGraph final : public Graph<T_vertices, T_edges> //final: calls on MatrixGraph objects are bound statically
 {
 private:
     unsigned verticesN;
-    std::vector<T_vertices> vertices; //data in vertices
-    std::vector<std::vector<T_edges*>> edges; //!connectivity matrix!
-
-    std::vector<std::vector<bool>> getMatrix() const; //returns copy of adjacency matrix (to change)
-    bool DFS(unsigned start, const std::vector<std::vector<bool>> &matrix) const;
-    std::vector<unsigned*> BFS(unsigned start, unsigned end) const;
+    VertexStore<T_vertices> vertices; //data in vertices, kept apart from topology
+    std::vector<std::vector<EdgePayload<T_edges>>> edges; //!connectivity matrix! (payloads of cells)
+    std::vector<BitRow> present; //presence bit of every cell
+    friend class AdaptiveGraph<T_vertices, T_edges>;
 public:
     MatrixGraph(); //empty constructor
     MatrixGraph(const MatrixGraph<T_vertices, T_edges> &toCopy); //copy constructor from MatrixGraph
     explicit MatrixGraph(const ListGraph<T_vertices, T_edges> &toCopy); //copy constructor from ListGraph
     ~MatrixGraph(); //destructor
+    void clear() override; //cleans the graph
+    void randomGraph(unsigned minVertices, unsigned maxVertices, double edgeProb, const T_vertices &verticesData, const T_edges &edgesData);
+        //fill graph with random number of vertices and random edges (hides the base version, no virtual calls)
     void addVertex(const T_vertices &data) override; //add a new vertex
     void delVertex(unsigned vertex) override; //delete a vertex
     void addEdge(unsigned from, unsigned to, const T_edges &data) override; //add a new edge
@@ -80,6 +140,23 @@ public:
     bool stronglyConnected() const override; //checks if the graph is strongly connected
     bool weaklyConnected() const override; //checks if the graph is weakly connected
     std::vector<unsigned> getPathVertices(unsigned from, unsigned to) const override; //returns vertices chain between 2 vertices [from-->to]
+    unsigned getPathLength(unsigned from, unsigned to) const; //returns number of edges between 2 vertices (or 0, if disconnected)
+    std::vector<unsigned> stronglyConnectedComponents() const override; //returns component id of every vertex
+    unsigned long long countTriangles() const; //returns number of triangles, edges are treated as undirected
+    std::vector<double> clusteringCoefficients() const; //returns local clustering coefficient of every vertex
+    CompressedGraph compress() const; //returns compressed copy of the structure (without data)
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const; //calls function(u) for every edge vertex-->u
+    template <class Function>
+    void forEachIn(unsigned vertex, const Function &function) const; //calls function(u) for every edge u-->vertex
+    template <class Function>
+    void forEachOutEdge(unsigned vertex, const Function &function) const; //calls function(u, data) for every edge vertex-->u
+    template <class A>
+    VertexAttribute<A> addVertexAttribute(const A &initial); //adds typed column stored apart from topology and vertices data
+    template <class A>
+    A& vertexAttribute(VertexAttribute<A> attribute, unsigned vertex); //get a reference to attribute of vertex
+    template <class A>
+    const A& vertexAttribute(VertexAttribute<A> attribute, unsigned vertex) const; //get a const reference to attribute of vertex
 
     MatrixGraph<T_vertices, T_edges>& operator=(const MatrixGraph<T_vertices, T_edges> &toCopy); //MatrixGraph = MatrixGraph
     MatrixGraph<T_vertices, T_edges>& operator=(const ListGraph<T_vertices, T_edges> &toCopy); //MatrixGraph = ListGraph
@@ -90,26 +167,43 @@ public:
 };
 
 template <class T_vertices, class T_edges>
-class ListGraph : public Graph<T_vertices, T_edges>
+class ListGraph final : public Graph<T_vertices, T_edges> //final: calls on ListGraph objects are bound statically
 {
 private:
     struct edge
     {
         unsigned vertex;
-        T_edges* data;
+        unsigned back; //position of the mirrored entry in inEdges[vertex] (with reverse index only)
+        EdgePayload<T_edges> data;
+    };
+    struct inEdge
+    {
+        unsigned vertex;
+        unsigned back; //position of the edge in edges[vertex]
     };
     unsigned verticesN;
-    std::vector<T_vertices> vertices; //data in vertices
+    VertexStore<T_vertices> vertices; //data in vertices, kept apart from topology
     std::vector<std::vector<edge>> edges; //!connectivity list!
-
-    std::vector<std::vector<unsigned>> getList() const; //returns copy of adjacency list (to change)
-    bool DFS(unsigned start, const std::vector<std::vector<unsigned>> &list) const;
-    std::vector<unsigned*> BFS(unsigned start, unsigned end) const;
+    std::vector<unsigned> inDegrees; //number of edges TO every vertex
+    std::vector<std::vector<inEdge>> inEdges; //!reverse connectivity list! (with reverse index only)
+    bool orderInsensitive; //deleted edges are replaced by the last edge of the row instead of shifting the row
+    bool reverseIndexed; //inEdges are maintained
+    friend class AdaptiveGraph<T_vertices, T_edges>;
+    friend class GraphJournal<T_vertices, T_edges>;
+
+    void appendEdge(unsigned from, unsigned to, const T_edges &data); //addEdge without checks (caller guarantees a new edge)
+    void removeOut(unsigned from, unsigned position); //removes entry from the row, fixes cross links of moved entries
+    void removeIn(unsigned to, unsigned position); //removes entry from the reverse row (swap with last)
+    void rebuildReverse(); //recounts in-degrees and refills reverse index from the rows
+    void delIndexedVertex(unsigned vertex); //delVertex with reverse index (edges are found without scanning rows)
 public:
     ListGraph(); //empty constructor
     ListGraph(const ListGraph<T_vertices, T_edges> &toCopy); //copy constructor from ListGraph
     explicit ListGraph(const MatrixGraph<T_vertices, T_edges> &toCopy); //copy constructor from MatrixGraph
     ~ListGraph(); //destructor
+    void clear() override; //cleans the graph
+    void randomGraph(unsigned minVertices, unsigned maxVertices, double edgeProb, const T_vertices &verticesData, const T_edges &edgesData);
+        //fill graph with random number of vertices and random edges (hides the base version, no virtual calls)
     void addVertex(const T_vertices &data) override; //add a new vertex
     void delVertex(unsigned vertex) override; //delete a vertex
     void addEdge(unsigned from, unsigned to, const T_edges &data) override; //add a new edge
@@ -121,6 +215,33 @@ public:
     bool stronglyConnected() const override; //checks if the graph is strongly connected
     bool weaklyConnected() const override; //checks if the graph is weakly connected
     std::vector<unsigned> getPathVertices(unsigned from, unsigned to) const override; //returns vertices chain between 2 vertices [from-->to]
+    unsigned getPathLength(unsigned from, unsigned to) const; //returns number of edges between 2 vertices (or 0, if disconnected)
+    std::vector<unsigned> stronglyConnectedComponents() const override; //returns component id of every vertex
+    unsigned long long countTriangles() const; //returns number of triangles, edges are treated as undirected
+    std::vector<double> clusteringCoefficients() const; //returns local clustering coefficient of every vertex
+    std::vector<unsigned> reorder(ReorderStrategy strategy); //renumbers vertices for locality, returns new number of every vertex
+    void setOrderInsensitive(bool enabled); //allows deletions to change the order of edges in rows (O(1) removal)
+    void enableReverseIndex(); //starts maintaining in-edges of every vertex
+    void disableReverseIndex(); //drops in-edges index
+    bool hasReverseIndex() const; //checks if in-edges index is maintained
+    unsigned outDegree(unsigned vertex) const; //returns the number of edges FROM vertex
+    unsigned inDegree(unsigned vertex) const; //returns the number of edges TO vertex
+    void applyBatch(const std::vector<EdgeInsert<T_edges>> &inserts, const std::vector<EdgeDelete> &deletes);
+        //deletes existing edges, then adds new ones, every touched row is rewritten once
+    void applyBatch(const EdgeBatch<T_edges> &batch); //applies batch (e.g. result of diff)
+    CompressedGraph compress() const; //returns compressed copy of the structure (without data)
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const; //calls function(u) for every edge vertex-->u
+    template <class Function>
+    void forEachIn(unsigned vertex, const Function &function) const; //calls function(u) for every edge u-->vertex (needs reverse index)
+    template <class Function>
+    void forEachOutEdge(unsigned vertex, const Function &function) const; //calls function(u, data) for every edge vertex-->u
+    template <class A>
+    VertexAttribute<A> addVertexAttribute(const A &initial); //adds typed column stored apart from topology and vertices data
+    template <class A>
+    A& vertexAttribute(VertexAttribute<A> attribute, unsigned vertex); //get a reference to attribute of vertex
+    template <class A>
+    const A& vertexAttribute(VertexAttribute<A> attribute, unsigned vertex) const; //get a const reference to attribute of vertex
 
     ListGraph<T_vertices, T_edges>& operator=(const ListGraph<T_vertices, T_edges> &toCopy); //ListGraph = ListGraph
     ListGraph<T_vertices, T_edges>& operator=(const MatrixGraph<T_vertices, T_edges> &toCopy); //ListGraph = MatrixGraph
@@ -130,6 +251,164 @@ public:
     const T_edges& operator()(unsigned from, unsigned to) const override; //get a const reference to edge
 };
 
+//graph which keeps its structure as a list while sparse and as a matrix while dense,
+//switching between them when density (edges/vertices^2) crosses the thresholds
+template <class T_vertices, class T_edges>
+class AdaptiveGraph : public Graph<T_vertices, T_edges>
+{
+private:
+    double toMatrixDensity; //list is converted to matrix when density rises to this value
+    double toListDensity; //matrix is converted to list when density falls to this value
+    unsigned minVertices; //smaller graphs keep their current representation
+    unsigned long long edgesN;
+    bool dense; //which representation is active
+    ListGraph<T_vertices, T_edges> list;
+    MatrixGraph<T_vertices, T_edges> matrix;
+
+    template <class Function>
+    decltype(auto) active(const Function &function) const; //calls function with active representation
+    template <class Function>
+    decltype(auto) active(const Function &function);
+    void adapt(); //switches representation if density crossed a threshold
+    void toMatrix(); //moves vertices and edge data from list to matrix
+    void toList(); //moves vertices and edge data from matrix to list
+public:
+    explicit AdaptiveGraph(double toMatrixDensity = 0.25, double toListDensity = 0.0625, unsigned minVertices = 16);
+    AdaptiveGraph(const AdaptiveGraph<T_vertices, T_edges> &toCopy); //copy constructor
+    bool isDense() const; //checks if matrix representation is active
+    unsigned long long edgesCount() const; //returns the number of edges in the graph
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const; //calls function(u) for every edge vertex-->u
+    template <class A>
+    VertexAttribute<A> addVertexAttribute(const A &initial); //adds typed column, it follows vertices between representations
+    template <class A>
+    A& vertexAttribute(VertexAttribute<A> attribute, unsigned vertex); //get a reference to attribute of vertex
+    template <class A>
+    const A& vertexAttribute(VertexAttribute<A> attribute, unsigned vertex) const; //get a const reference to attribute of vertex
+    void clear() override; //cleans the graph
+    void addVertex(const T_vertices &data) override; //add a new vertex
+    void delVertex(unsigned vertex) override; //delete a vertex
+    void addEdge(unsigned from, unsigned to, const T_edges &data) override; //add a new edge
+    void delEdge(unsigned from, unsigned to) override; //delete an edge
+    bool isEdgeExists(unsigned from, unsigned to) const override; //checks if there's an edge in the graph
+    unsigned size() const override; //returns the number of vertices in the graph
+    std::vector<std::vector<unsigned>> getEdges() const override; //return all edges in graph
+    std::string toString() const override; //return a string representation of active representation
+    bool stronglyConnected() const override; //checks if the graph is strongly connected
+    bool weaklyConnected() const override; //checks if the graph is weakly connected
+    std::vector<unsigned> getPathVertices(unsigned from, unsigned to) const override; //returns vertices chain between 2 vertices [from-->to]
+    std::vector<unsigned> stronglyConnectedComponents() const override; //returns component id of every vertex
+    unsigned long long countTriangles() const; //returns number of triangles, edges are treated as undirected
+    std::vector<double> clusteringCoefficients() const; //returns local clustering coefficient of every vertex
+
+    AdaptiveGraph<T_vertices, T_edges>& operator=(const AdaptiveGraph<T_vertices, T_edges> &toCopy); //AdaptiveGraph = AdaptiveGraph
+    AdaptiveGraph<T_vertices, T_edges>& operator=(const Graph<T_vertices, T_edges> &toCopy); //AdaptiveGraph = any graph
+    T_vertices& operator()(unsigned vertex) override; //get a reference to vertex
+    const T_vertices& operator()(unsigned vertex) const override; //get a const reference to vertex
+    T_edges& operator()(unsigned from, unsigned to) override; //get a reference to edge
+    const T_edges& operator()(unsigned from, unsigned to) const override; //get a const reference to edge
+};
+
+//read-only version of a ConcurrentListGraph, safe to query from any number of threads without locks
+template <class T_vertices, class T_edges>
+class ListGraphSnapshot
+{
+private:
+    friend class ConcurrentListGraph<T_vertices, T_edges>;
+    struct edge
+    {
+        unsigned vertex;
+        std::shared_ptr<const T_edges> data;
+    };
+    struct row //vertex with its out-edges, shared between versions until changed
+    {
+        std::shared_ptr<const T_vertices> data;
+        std::vector<edge> edges;
+        unsigned long long generation; //version which created this row
+    };
+    struct chunk //rows of chunkSize consecutive vertices, shared between versions until changed
+    {
+        std::vector<std::shared_ptr<row>> rows;
+        unsigned long long generation; //version which created this chunk
+    };
+    static const unsigned chunkBits = 6;
+    static const unsigned chunkSize = 1u<<chunkBits;
+    unsigned long long versionN;
+    unsigned verticesN;
+    std::vector<std::shared_ptr<chunk>> chunks;
+
+    const row& getRow(unsigned vertex) const;
+public:
+    unsigned long long version() const; //returns number of the version
+    unsigned size() const; //returns the number of vertices in the graph
+    bool isEdgeExists(unsigned from, unsigned to) const; //checks if there's an edge in the graph
+    std::vector<std::vector<unsigned>> getEdges() const; //return all edges in graph
+    std::vector<unsigned> getPathVertices(unsigned from, unsigned to) const; //returns vertices chain between 2 vertices [from-->to]
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const; //calls function(u) for every edge vertex-->u
+    const T_vertices& operator()(unsigned vertex) const; //get a const reference to vertex
+    const T_edges& operator()(unsigned from, unsigned to) const; //get a const reference to edge
+};
+
+//list graph with a single writer and snapshot readers: changes are collected in a pending version
+//(copy-on-write of touched chunks and rows) and become visible to new snapshots on publish()
+template <class T_vertices, class T_edges>
+class ConcurrentListGraph
+{
+private:
+    typedef ListGraphSnapshot<T_vertices, T_edges> snapshot_t;
+    std::shared_ptr<snapshot_t> published; //latest visible version (accessed atomically)
+    std::shared_ptr<snapshot_t> pending; //version being changed by the writer (nullptr if no changes)
+
+    snapshot_t& getPending(); //returns pending version, starting it if needed
+    typename snapshot_t::row& mutableRow(unsigned vertex); //returns a row owned by pending version
+public:
+    ConcurrentListGraph(); //empty constructor
+    explicit ConcurrentListGraph(const ListGraph<T_vertices, T_edges> &toCopy); //copy constructor from ListGraph
+    ConcurrentListGraph(const ConcurrentListGraph<T_vertices, T_edges> &toCopy) = delete;
+    ConcurrentListGraph<T_vertices, T_edges>& operator=(const ConcurrentListGraph<T_vertices, T_edges> &toCopy) = delete;
+    void addVertex(const T_vertices &data); //add a new vertex
+    void delVertex(unsigned vertex); //delete a vertex
+    void addEdge(unsigned from, unsigned to, const T_edges &data); //add a new edge
+    void delEdge(unsigned from, unsigned to); //delete an edge
+    void setVertex(unsigned vertex, const T_vertices &data); //replace data in vertex
+    void setEdge(unsigned from, unsigned to, const T_edges &data); //replace data in edge
+    void publish(); //make all changes visible to new snapshots
+    std::shared_ptr<const ListGraphSnapshot<T_vertices, T_edges>> snapshot() const; //latest published version (any thread)
+};
+
+//read-only adjacency without edge data: sorted neighbours of every vertex are stored as varint deltas
+class CompressedGraph
+{
+private:
+    unsigned verticesN;
+    unsigned long long edgesN;
+    static const unsigned blockShift = 6; //rows are grouped in blocks of 64, every block has a 64-bit base offset
+    std::vector<unsigned long long> bases; //start of every block of rows in data
+    std::vector<unsigned> offsets; //start of every row relative to the base of its block (row = varint degree, then varint deltas)
+    std::vector<unsigned char> data; //encoded rows, padded with 8 zero bytes for word reads
+
+    const unsigned char* rowStart(unsigned vertex) const; //start of the encoded row of vertex
+    static void encode(std::vector<unsigned char> &buffer, unsigned value);
+    static unsigned decode(const unsigned char *&pos);
+    static unsigned first(unsigned vertex, unsigned zigzag); //decodes first neighbour of vertex
+public:
+    CompressedGraph(); //empty graph
+    template <class G>
+    explicit CompressedGraph(const G &graph); //compresses structure of any graph with forEachOut
+    unsigned size() const; //returns the number of vertices in the graph
+    unsigned long long edgesCount() const; //returns the number of edges in the graph
+    unsigned long long memoryBytes() const; //returns size of the stored topology
+    unsigned outDegree(unsigned vertex) const; //returns number of edges from vertex
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const; //calls function(u) for every edge vertex-->u, ascending
+    bool isEdgeExists(unsigned from, unsigned to) const; //checks if there's an edge in the graph
+    std::vector<std::vector<unsigned>> getEdges() const; //return all edges in graph
+    std::vector<unsigned> getPathVertices(unsigned from, unsigned to) const; //returns vertices chain between 2 vertices [from-->to]
+    CompressedGraph transposed() const; //returns graph with reversed edges
+    std::vector<unsigned> stronglyConnectedComponents() const; //returns component id of every vertex
+};
+
 //---------------------------------------------------------------------------------------------------------------//
 // functions related to class Graph
 
@@ -160,9 +439,9 @@ void Graph<T_vertices, T_edges>::randomGraph(unsigned minVertices, unsigned maxV
     {
         this->addVertex(verticesData);
     }
-    for(unsigned i=0; i<size(); i++)
+    for(unsigned i=0; i<n; i++)
     {
-        for(unsigned j=0; j<size(); j++)
+        for(unsigned j=0; j<n; j++)
         {
             isEdge = randDouble(mt);
             if(isEdge<edgeProb)
@@ -185,7 +464,8 @@ template <class T_vertices, class T_edges>
 Graph<T_vertices, T_edges>& Graph<T_vertices, T_edges>::operator=(const Graph<T_vertices, T_edges> &toCopy)
 {
     this->clear();
-    for(unsigned i=0; i<toCopy.size(); i++)
+    unsigned verticesN = toCopy.size();
+    for(unsigned i=0; i<verticesN; i++)
     {
         this->addVertex(toCopy(i));
     }
@@ -197,6 +477,25 @@ Graph<T_vertices, T_edges>& Graph<T_vertices, T_edges>::operator=(const Graph<T_
     return *this;
 }
 
+template <class T_vertices, class T_edges>
+void Graph<T_vertices, T_edges>::enableCache(unsigned capacity)
+{
+    assert(capacity>0);
+    cache.setCapacity(capacity);
+}
+
+template <class T_vertices, class T_edges>
+void Graph<T_vertices, T_edges>::disableCache()
+{
+    cache.setCapacity(0);
+}
+
+template <class T_vertices, class T_edges>
+QueryCacheStats Graph<T_vertices, T_edges>::cacheStats() const
+{
+    return cache.getStats();
+}
+
 template <class T_vertices, class T_edges>
 std::ostream& operator <<(std::ostream &ofs, const Graph<T_vertices, T_edges> &graph)
 {
@@ -205,78 +504,272 @@ std::ostream& operator <<(std::ostream &ofs, const Graph<T_vertices, T_edges> &g
 }
 
 //---------------------------------------------------------------------------------------------------------------//
-// functions related to class MatrixGraph
+// functions related to class QueryCache
 
-template <class T_vertices, class T_edges>
-bool MatrixGraph<T_vertices, T_edges>::DFS(unsigned start, const std::vector<std::vector<bool>> &matrix) const
+inline void QueryCache::sync(unsigned long long graphVersion)
+{
+    if(version==graphVersion) return;
+    version = graphVersion;
+    flags[strong] = flags[weak] = -1;
+    paths.clear();
+    index.clear();
+}
+
+inline void QueryCache::setCapacity(unsigned newCapacity)
 {
-    auto visited = new bool[verticesN]{false};
-    std::stack<unsigned> stack;
-    stack.push(start);
-    unsigned curr;
-    while(!stack.empty())
+    std::lock_guard<std::mutex> guard(mutex);
+    capacity = newCapacity;
+    while(paths.size()>newCapacity)
     {
-        curr = stack.top();
-        stack.pop();
-        if(!visited[curr])
-        {
-            visited[curr] = true;
-            for(unsigned i=0; i<verticesN; i++)
-            {
-                if(matrix[curr][i]) stack.push(i);
-            }
-        }
+        index.erase(paths.back().first);
+        paths.pop_back();
     }
-    for(unsigned i=0; i<verticesN; i++)
+    if(newCapacity==0) flags[strong] = flags[weak] = -1;
+}
+
+inline QueryCacheStats QueryCache::getStats() const
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return stats;
+}
+
+inline bool QueryCache::findFlag(unsigned long long graphVersion, Flag flag, bool &res)
+{
+    if(capacity==0) return false;
+    std::lock_guard<std::mutex> guard(mutex);
+    sync(graphVersion);
+    if(flags[flag]<0)
+    {
+        stats.misses++;
+        return false;
+    }
+    stats.hits++;
+    res = flags[flag];
+    return true;
+}
+
+inline void QueryCache::storeFlag(unsigned long long graphVersion, Flag flag, bool value)
+{
+    if(capacity==0) return;
+    std::lock_guard<std::mutex> guard(mutex);
+    sync(graphVersion);
+    flags[flag] = value;
+}
+
+inline bool QueryCache::findPath(unsigned long long graphVersion, unsigned from, unsigned to, std::vector<unsigned> &res)
+{
+    if(capacity==0) return false;
+    std::lock_guard<std::mutex> guard(mutex);
+    sync(graphVersion);
+    auto found = index.find((unsigned long long)from<<32 | to);
+    if(found==index.end())
+    {
+        stats.misses++;
+        return false;
+    }
+    stats.hits++;
+    paths.splice(paths.begin(), paths, found->second);
+    res = found->second->second;
+    return true;
+}
+
+inline void QueryCache::storePath(unsigned long long graphVersion, unsigned from, unsigned to, const std::vector<unsigned> &path)
+{
+    if(capacity==0) return;
+    std::lock_guard<std::mutex> guard(mutex);
+    sync(graphVersion);
+    unsigned long long key = (unsigned long long)from<<32 | to;
+    if(index.count(key)) return;
+    paths.emplace_front(key, path);
+    index[key] = paths.begin();
+    while(paths.size()>capacity)
+    {
+        index.erase(paths.back().first);
+        paths.pop_back();
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class CompressedGraph
+
+inline void CompressedGraph::encode(std::vector<unsigned char> &buffer, unsigned value)
+{
+    while(value>=0x80)
+    {
+        buffer.push_back((unsigned char)(value|0x80));
+        value >>= 7;
+    }
+    buffer.push_back((unsigned char)value);
+}
+
+inline unsigned CompressedGraph::decode(const unsigned char *&pos)
+{
+    unsigned res = *pos&0x7f;
+    unsigned shift = 7;
+    while(*pos++&0x80)
+    {
+        res |= (unsigned)(*pos&0x7f)<<shift;
+        shift += 7;
+    }
+    return res;
+}
+
+inline unsigned CompressedGraph::first(unsigned vertex, unsigned zigzag)
+{
+    if(zigzag&1) return vertex-(zigzag>>1)-1;
+    return vertex+(zigzag>>1);
+}
+
+inline const unsigned char* CompressedGraph::rowStart(unsigned vertex) const
+{
+    return data.data()+bases[vertex>>blockShift]+offsets[vertex];
+}
+
+inline CompressedGraph::CompressedGraph()
+{
+    verticesN = 0;
+    edgesN = 0;
+    data.assign(8, 0);
+}
+
+template <class G>
+CompressedGraph::CompressedGraph(const G &graph)
+{
+    verticesN = graph.size();
+    assert(verticesN<=1u<<31); //zigzag of the first neighbour must fit
+    edgesN = 0;
+    bases.reserve((verticesN>>blockShift)+1);
+    offsets.reserve(verticesN);
+    std::vector<unsigned> row;
+    for(unsigned v=0; v<verticesN; v++)
     {
-        if(!visited[i])
+        if((v&((1u<<blockShift)-1))==0) bases.push_back(data.size());
+        assert(data.size()-bases.back()<=std::numeric_limits<unsigned>::max()); //block must fit 32-bit relative offsets
+        offsets.push_back(data.size()-bases.back());
+        row.clear();
+        graph.forEachOut(v, [&row](unsigned u){ row.push_back(u); });
+        std::sort(row.begin(), row.end());
+        encode(data, row.size());
+        unsigned prev = 0;
+        for(unsigned i=0; i<row.size(); i++)
         {
-            delete []visited;
-            return false;
+            assert(i==0 || row[i]!=row[i-1]);
+            if(i==0) encode(data, row[i]>=v ? 2*(row[i]-v) : 2*(v-row[i])-1); //first neighbour relative to vertex (zigzag)
+            else encode(data, row[i]-prev-1); //neighbours are distinct, so deltas are at least 1
+            prev = row[i];
         }
+        edgesN += row.size();
     }
-    delete []visited;
-    return true;
+    data.resize(data.size()+8, 0);
+    data.shrink_to_fit();
 }
 
-template <class T_vertices, class T_edges>
-std::vector<unsigned*> MatrixGraph<T_vertices, T_edges>::BFS(unsigned start, unsigned end) const
+inline unsigned CompressedGraph::size() const
+{
+    return verticesN;
+}
+
+inline unsigned long long CompressedGraph::edgesCount() const
+{
+    return edgesN;
+}
+
+inline unsigned long long CompressedGraph::memoryBytes() const
+{
+    return data.size()+offsets.size()*sizeof(unsigned)+bases.size()*sizeof(unsigned long long);
+}
+
+inline unsigned CompressedGraph::outDegree(unsigned vertex) const
 {
-    std::vector<unsigned*> prev{verticesN,nullptr};
-    auto visited = new bool[verticesN]{false};
-    std::queue<unsigned> queue;
-    visited[start] = true;
-    queue.push(start);
-    unsigned curr;
-    while(!queue.empty())
+    assert(vertex<verticesN);
+    const unsigned char *pos = rowStart(vertex);
+    return decode(pos);
+}
+
+template <class Function>
+void CompressedGraph::forEachOut(unsigned vertex, const Function &function) const
+{
+    assert(vertex<verticesN);
+    const unsigned char *pos = rowStart(vertex);
+    unsigned left = decode(pos);
+    if(left==0) return;
+    unsigned curr = first(vertex, decode(pos));
+    function(curr);
+    left--;
+    while(left>0)
     {
-        curr = queue.front();
-        queue.pop();
-        for(unsigned i=0; i<verticesN; i++)
+        //fast path: 8 one-byte deltas in a row are decoded from a single word
+        if(left>=8)
         {
-            if(edges[curr][i] && !visited[i])
+            unsigned long long word;
+            std::memcpy(&word, pos, 8);
+            if((word&0x8080808080808080ull)==0)
             {
-                visited[i] = true;
-                queue.push(i);
-                prev[i] = new unsigned{curr};
-                if(i==end)
+                for(unsigned i=0; i<8; i++)
                 {
-                    delete []visited;
-                    return prev;
+                    curr += (unsigned)(word>>(8*i)&0xff)+1;
+                    function(curr);
                 }
+                pos += 8;
+                left -= 8;
+                continue;
             }
         }
+        curr += decode(pos)+1;
+        function(curr);
+        left--;
+    }
+}
+
+inline bool CompressedGraph::isEdgeExists(unsigned from, unsigned to) const
+{
+    assert(from<verticesN && to<verticesN);
+    const unsigned char *pos = rowStart(from);
+    unsigned left = decode(pos);
+    unsigned curr = 0;
+    for(unsigned i=0; i<left; i++)
+    {
+        curr = i==0 ? first(from, decode(pos)) : curr+decode(pos)+1;
+        if(curr>=to) return curr==to;
+    }
+    return false;
+}
+
+inline std::vector<std::vector<unsigned>> CompressedGraph::getEdges() const
+{
+    std::vector<std::vector<unsigned>> res;
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        forEachOut(i, [&res, i](unsigned u){ res.push_back({i,u}); });
     }
-    delete []visited;
-    return prev;
+    return res;
+}
+
+inline std::vector<unsigned> CompressedGraph::getPathVertices(unsigned from, unsigned to) const
+{
+    return pathVertices(*this, from, to);
+}
+
+inline CompressedGraph CompressedGraph::transposed() const
+{
+    return CompressedGraph(::transposed(*this)); //rows of flat arrays come out sorted
+}
+
+inline std::vector<unsigned> CompressedGraph::stronglyConnectedComponents() const
+{
+    return strongComponents(*this, transposed());
 }
 
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class MatrixGraph
+
 template <class T_vertices, class T_edges>
 MatrixGraph<T_vertices, T_edges>::MatrixGraph()
 {
     verticesN = 0;
     vertices = {};
     edges = {};
+    present = {};
 }
 
 template <class T_vertices, class T_edges>
@@ -299,15 +792,46 @@ MatrixGraph<T_vertices, T_edges>::~MatrixGraph()
     this->clear();
 }
 
+template <class T_vertices, class T_edges>
+void MatrixGraph<T_vertices, T_edges>::clear()
+{
+    this->version++;
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        forEachBit(present[i], [&](unsigned j){ edges[i][j].destroy(); });
+    }
+    edges.clear();
+    present.clear();
+    vertices.clear();
+    verticesN = 0;
+}
+
+template <class T_vertices, class T_edges>
+void MatrixGraph<T_vertices, T_edges>::randomGraph(unsigned minVertices, unsigned maxVertices,
+                                                   double edgeProb, const T_vertices &verticesData, const T_edges &edgesData)
+{
+    assert(minVertices<=maxVertices);
+    clear();
+    std::uniform_int_distribution<unsigned> randInt(minVertices, maxVertices);
+    randomFill(*this, randInt(mt), edgeProb, verticesData, edgesData, mt);
+}
+
 template <class T_vertices, class T_edges>
 void MatrixGraph<T_vertices, T_edges>::addVertex(const T_vertices &data)
 {
+    this->version++;
     vertices.push_back(data);
-    edges.push_back(std::vector<T_edges*> (edges.size()+1, nullptr));
+    edges.push_back(std::vector<EdgePayload<T_edges>> (edges.size()+1));
     for(auto i = edges.begin(); i < edges.end()-1; i++)
     {
-        (*i).push_back(nullptr);
+        (*i).push_back({});
+    }
+    unsigned words = verticesN/64+1;
+    for(auto &i : present)
+    {
+        if(i.size()<words) i.push_back(0);
     }
+    present.push_back(BitRow(words, 0));
     verticesN++;
 }
 
@@ -315,44 +839,49 @@ template <class T_vertices, class T_edges>
 void MatrixGraph<T_vertices, T_edges>::delVertex(unsigned vertex)
 {
     assert(vertex<verticesN);
-    vertices.erase(vertices.begin()+vertex); //erasing vertex (with data)
+    this->version++;
+    vertices.erase(vertex); //erasing vertex (only the last payload is moved)
     //deleting data in all edges FROM vertex
-    for(auto i = edges[vertex].begin(); i < edges[vertex].end(); i++)
-    {
-        delete (*i);
-    }
+    forEachBit(present[vertex], [&](unsigned j){ edges[vertex][j].destroy(); });
     edges.erase(edges.begin()+vertex); //erasing row from the connectivity matrix
+    present.erase(present.begin()+vertex);
+    verticesN--;
     //deleting data in all edges TO vertex, erasing column of the connectivity matrix
-    for(auto i = edges.begin(); i < edges.end(); i++)
+    unsigned words = (verticesN+63)/64;
+    for(unsigned i=0; i<verticesN; i++)
     {
-        delete (*i)[vertex];
-        (*i).erase((*i).begin()+vertex);
+        if(testBit(present[i], vertex)) edges[i][vertex].destroy();
+        edges[i].erase(edges[i].begin()+vertex);
+        eraseBit(present[i], vertex);
+        present[i].resize(words);
     }
-    verticesN--;
 }
 
 template <class T_vertices, class T_edges>
 void MatrixGraph<T_vertices, T_edges>::addEdge(unsigned from, unsigned to, const T_edges &data)
 {
     assert(from<verticesN && to<verticesN);
-    assert(!edges[from][to]);
-    edges[from][to] = new T_edges(data);
+    assert(!testBit(present[from], to));
+    this->version++;
+    edges[from][to].create(data);
+    setBit(present[from], to);
 }
 
 template <class T_vertices, class T_edges>
 void MatrixGraph<T_vertices, T_edges>::delEdge(unsigned from, unsigned to)
 {
     assert(from<verticesN && to<verticesN);
-    assert(edges[from][to]);
-    delete edges[from][to];
-    edges[from][to] = nullptr;
+    assert(testBit(present[from], to));
+    this->version++;
+    edges[from][to].destroy();
+    resetBit(present[from], to);
 }
 
 template <class T_vertices, class T_edges>
 bool MatrixGraph<T_vertices, T_edges>::isEdgeExists(unsigned from, unsigned to) const
 {
     assert(from<verticesN && to<verticesN);
-    return edges[from][to];
+    return testBit(present[from], to);
 }
 
 template <class T_vertices, class T_edges>
@@ -367,26 +896,7 @@ std::vector<std::vector<unsigned>> MatrixGraph<T_vertices, T_edges>::getEdges()
     std::vector<std::vector<unsigned>> res;
     for(unsigned i=0; i<verticesN; i++)
     {
-        for(unsigned j=0; j<verticesN; j++)
-        {
-            if(edges[i][j]) res.push_back({i,j});
-        }
-    }
-    return res;
-}
-
-template <class T_vertices, class T_edges>
-std::vector<std::vector<bool>> MatrixGraph<T_vertices, T_edges>::getMatrix() const
-{
-    std::vector<std::vector<bool>> res;
-    for(unsigned i=0; i<verticesN; i++)
-    {
-        res.emplace_back();
-        for(unsigned j=0; j<verticesN; j++)
-        {
-            if(edges[i][j]) res.back().push_back(true);
-            else res.back().push_back(false);
-        }
+        forEachBit(present[i], [&](unsigned j){ res.push_back({i,j}); });
     }
     return res;
 }
@@ -399,7 +909,7 @@ std::string MatrixGraph<T_vertices, T_edges>::toString() const
     {
         for(unsigned j=0; j<verticesN; j++)
         {
-            if(edges[i][j]) res += "1 ";
+            if(testBit(present[i], j)) res += "1 ";
             else res += "0 ";
         }
         res += "\n";
@@ -411,33 +921,22 @@ template <class T_vertices, class T_edges>
 bool MatrixGraph<T_vertices, T_edges>::stronglyConnected() const
 {
     assert(verticesN>0);
-    auto matrix = this->getMatrix();
-    if(!DFS(0, matrix)) return false;
-    for(unsigned i=0; i<verticesN; i++)
-    {
-        for(unsigned  j=i+1; j<verticesN; j++)
-        {
-            swap(matrix[i][j], matrix[j][i]);
-        }
-    }
-    return DFS(0, matrix);
+    bool res;
+    if(this->cache.findStrongly(this->version, res)) return res;
+    res = isStronglyConnected(*this);
+    this->cache.storeStrongly(this->version, res);
+    return res;
 }
 
 template <class T_vertices, class T_edges>
 bool MatrixGraph<T_vertices, T_edges>::weaklyConnected() const
 {
     assert(verticesN>0);
-    auto matrix = this->getMatrix();
-    for(unsigned i=0; i<verticesN; i++)
-    {
-        for(unsigned  j=i+1; j<verticesN; j++)
-        {
-            matrix[i][j] = matrix[i][j] || matrix[j][i];
-            matrix[j][i] = matrix[i][j];
-        }
-    }
-    if(!DFS(0, matrix)) return false;
-    return true;
+    bool res;
+    if(this->cache.findWeakly(this->version, res)) return res;
+    res = isWeaklyConnected(*this);
+    this->cache.storeWeakly(this->version, res);
+    return res;
 }
 
 template <class T_vertices, class T_edges>
@@ -445,149 +944,176 @@ std::vector<unsigned> MatrixGraph<T_vertices, T_edges>::getPathVertices(unsigned
 {
     assert(from!=to);
     std::vector<unsigned> route;
-    std::vector<unsigned*> prev = this->BFS(from, to);
-    unsigned curr;
-    if(prev[to])
-    {
-        route.push_back(to);
-        curr = *prev[to];
-        while(curr!=from)
-        {
-            route.push_back(curr);
-            curr = *prev[curr];
-        }
-        route.push_back(from);
-    }
-    for(auto &i: prev) delete i;
-    std::reverse(route.begin(), route.end());
+    if(this->cache.findPath(this->version, from, to, route)) return route;
+    route = pathVertices(*this, from, to);
+    this->cache.storePath(this->version, from, to, route);
     return route;
 }
 
 template <class T_vertices, class T_edges>
-MatrixGraph<T_vertices, T_edges>& MatrixGraph<T_vertices, T_edges>::operator=(const MatrixGraph<T_vertices, T_edges> &toCopy)
+unsigned MatrixGraph<T_vertices, T_edges>::getPathLength(unsigned from, unsigned to) const
 {
-    Graph<T_vertices, T_edges>::operator=(toCopy);
-    return *this;
+    assert(from!=to);
+    if(!this->cache.enabled()) return pathLength(*this, from, to);
+    std::vector<unsigned> route;
+    if(!this->cache.findPath(this->version, from, to, route))
+    {
+        route = pathVertices(*this, from, to); //the route is stored, so later length and route queries hit
+        this->cache.storePath(this->version, from, to, route);
+    }
+    return route.empty() ? 0 : route.size()-1;
 }
 
 template <class T_vertices, class T_edges>
-MatrixGraph<T_vertices, T_edges>& MatrixGraph<T_vertices, T_edges>::operator=(const ListGraph<T_vertices, T_edges> &toCopy)
+std::vector<unsigned> MatrixGraph<T_vertices, T_edges>::stronglyConnectedComponents() const
 {
-    Graph<T_vertices, T_edges>::operator=(toCopy);
-    return *this;
+    return strongComponents(*this, reversedView(*this)); //columns of the matrix are in-edges
 }
 
 template <class T_vertices, class T_edges>
-T_vertices& MatrixGraph<T_vertices, T_edges>::operator()(unsigned vertex)
+unsigned long long MatrixGraph<T_vertices, T_edges>::countTriangles() const
+{
+    return ::countTriangles(*this, TriangleStrategy::bitset);
+}
+
+template <class T_vertices, class T_edges>
+std::vector<double> MatrixGraph<T_vertices, T_edges>::clusteringCoefficients() const
+{
+    return ::clusteringCoefficients(*this, TriangleStrategy::bitset);
+}
+
+template <class T_vertices, class T_edges>
+template <class Function>
+void MatrixGraph<T_vertices, T_edges>::forEachOut(unsigned vertex, const Function &function) const
 {
     assert(vertex<verticesN);
-    return vertices[vertex];
+    forEachBit(present[vertex], function); //64 cells per word
 }
 
 template <class T_vertices, class T_edges>
-const T_vertices& MatrixGraph<T_vertices, T_edges>::operator()(unsigned vertex) const
+template <class Function>
+void MatrixGraph<T_vertices, T_edges>::forEachIn(unsigned vertex, const Function &function) const
 {
     assert(vertex<verticesN);
-    return vertices[vertex];
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        if(testBit(present[i], vertex)) function(i);
+    }
 }
 
 template <class T_vertices, class T_edges>
-T_edges& MatrixGraph<T_vertices, T_edges>::operator()(unsigned from, unsigned to)
+template <class Function>
+void MatrixGraph<T_vertices, T_edges>::forEachOutEdge(unsigned vertex, const Function &function) const
 {
-    assert(from<verticesN && to<verticesN);
-    assert(edges[from][to]);
-    return *edges[from][to];
+    assert(vertex<verticesN);
+    const EdgePayload<T_edges> *row = edges[vertex].data();
+    forEachBit(present[vertex], [&](unsigned i){ function(i, row[i].get()); });
 }
 
 template <class T_vertices, class T_edges>
-const T_edges& MatrixGraph<T_vertices, T_edges>::operator()(unsigned from, unsigned to) const
+template <class A>
+VertexAttribute<A> MatrixGraph<T_vertices, T_edges>::addVertexAttribute(const A &initial)
 {
-    assert(from<verticesN && to<verticesN);
-    assert(edges[from][to]);
-    return *edges[from][to];
+    return vertices.addAttribute(initial);
 }
 
-//---------------------------------------------------------------------------------------------------------------//
-//functions related to class ListGraph
+template <class T_vertices, class T_edges>
+template <class A>
+A& MatrixGraph<T_vertices, T_edges>::vertexAttribute(VertexAttribute<A> attribute, unsigned vertex)
+{
+    assert(vertex<verticesN);
+    return vertices.attribute(attribute, vertex);
+}
 
 template <class T_vertices, class T_edges>
-bool ListGraph<T_vertices, T_edges>::DFS(unsigned start, const std::vector<std::vector<unsigned>> &list) const
+template <class A>
+const A& MatrixGraph<T_vertices, T_edges>::vertexAttribute(VertexAttribute<A> attribute, unsigned vertex) const
 {
-    auto visited = new bool[verticesN]{false};
-    std::stack<unsigned> stack;
-    stack.push(start);
-    unsigned curr, currLen;
-    while(!stack.empty())
-    {
-        curr = stack.top();
-        stack.pop();
-        if(!visited[curr])
-        {
-            visited[curr] = true;
-            currLen = list[curr].size();
-            for(unsigned i=0; i<currLen; i++)
-            {
-                stack.push(list[curr][i]);
-            }
-        }
-    }
+    assert(vertex<verticesN);
+    return vertices.attribute(attribute, vertex);
+}
+
+template <class T_vertices, class T_edges>
+CompressedGraph MatrixGraph<T_vertices, T_edges>::compress() const
+{
+    return CompressedGraph(*this);
+}
+
+template <class T_vertices, class T_edges>
+MatrixGraph<T_vertices, T_edges>& MatrixGraph<T_vertices, T_edges>::operator=(const MatrixGraph<T_vertices, T_edges> &toCopy)
+{
+    //same representation is copied row by row, without virtual calls per element
+    if(this==&toCopy) return *this;
+    this->clear();
+    vertices = toCopy.vertices;
+    verticesN = toCopy.verticesN;
+    edges = toCopy.edges;
+    present = toCopy.present;
     for(unsigned i=0; i<verticesN; i++)
     {
-        if(!visited[i])
-        {
-            delete []visited;
-            return false;
-        }
+        forEachBit(present[i], [&](unsigned j){ edges[i][j].copy(); });
     }
-    delete []visited;
-    return true;
+    return *this;
 }
 
 template <class T_vertices, class T_edges>
-std::vector<unsigned*> ListGraph<T_vertices, T_edges>::BFS(unsigned start, unsigned end) const
+MatrixGraph<T_vertices, T_edges>& MatrixGraph<T_vertices, T_edges>::operator=(const ListGraph<T_vertices, T_edges> &toCopy)
 {
-    std::vector<unsigned*> prev{verticesN,nullptr};
-    auto visited = new bool[verticesN]{false};
-    std::queue<unsigned> queue;
-    visited[start] = true;
-    queue.push(start);
-    unsigned curr, currLen;
-    while(!queue.empty())
-    {
-        curr = queue.front();
-        queue.pop();
-        currLen = edges[curr].size();
-        for(unsigned i=0; i<currLen; i++)
-        {
-            if(!visited[edges[curr][i].vertex])
-            {
-                visited[edges[curr][i].vertex] = true;
-                queue.push(edges[curr][i].vertex);
-                prev[edges[curr][i].vertex] = new unsigned{curr};
-                if(edges[curr][i].vertex==end)
-                {
-                    delete []visited;
-                    return prev;
-                }
-            }
-        }
-    }
-    delete []visited;
-    return prev;
+    Graph<T_vertices, T_edges>::operator=(toCopy);
+    return *this;
+}
+
+template <class T_vertices, class T_edges>
+T_vertices& MatrixGraph<T_vertices, T_edges>::operator()(unsigned vertex)
+{
+    assert(vertex<verticesN);
+    return vertices[vertex];
 }
 
+template <class T_vertices, class T_edges>
+const T_vertices& MatrixGraph<T_vertices, T_edges>::operator()(unsigned vertex) const
+{
+    assert(vertex<verticesN);
+    return vertices[vertex];
+}
+
+template <class T_vertices, class T_edges>
+T_edges& MatrixGraph<T_vertices, T_edges>::operator()(unsigned from, unsigned to)
+{
+    assert(from<verticesN && to<verticesN);
+    assert(testBit(present[from], to));
+    return edges[from][to].get();
+}
+
+template <class T_vertices, class T_edges>
+const T_edges& MatrixGraph<T_vertices, T_edges>::operator()(unsigned from, unsigned to) const
+{
+    assert(from<verticesN && to<verticesN);
+    assert(testBit(present[from], to));
+    return edges[from][to].get();
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+//functions related to class ListGraph
+
 template <class T_vertices, class T_edges>
 ListGraph<T_vertices, T_edges>::ListGraph()
 {
     verticesN = 0;
     vertices = {};
     edges = {};
+    inDegrees = {};
+    inEdges = {};
+    orderInsensitive = false;
+    reverseIndexed = false;
 }
 
 template <class T_vertices, class T_edges>
 ListGraph<T_vertices, T_edges>::ListGraph(const ListGraph<T_vertices, T_edges> &toCopy)
 {
     verticesN = 0;
+    orderInsensitive = false;
+    reverseIndexed = false;
     *this = toCopy;
 }
 
@@ -595,6 +1121,8 @@ template <class T_vertices, class T_edges>
 ListGraph<T_vertices, T_edges>::ListGraph(const MatrixGraph<T_vertices, T_edges> &toCopy)
 {
     verticesN = 0;
+    orderInsensitive = false;
+    reverseIndexed = false;
     *this = toCopy;
 }
 
@@ -604,11 +1132,39 @@ ListGraph<T_vertices, T_edges>::~ListGraph()
     this->clear();
 }
 
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::clear()
+{
+    this->version++;
+    for(auto &i : edges)
+    {
+        for(auto &j : i) j.data.destroy();
+    }
+    edges.clear();
+    inDegrees.clear();
+    inEdges.clear();
+    vertices.clear();
+    verticesN = 0;
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::randomGraph(unsigned minVertices, unsigned maxVertices,
+                                                 double edgeProb, const T_vertices &verticesData, const T_edges &edgesData)
+{
+    assert(minVertices<=maxVertices);
+    clear();
+    std::uniform_int_distribution<unsigned> randInt(minVertices, maxVertices);
+    randomFill(*this, randInt(mt), edgeProb, verticesData, edgesData, mt);
+}
+
 template <class T_vertices, class T_edges>
 void ListGraph<T_vertices, T_edges>::addVertex(const T_vertices &data)
 {
+    this->version++;
     vertices.push_back(data);
     edges.push_back({});
+    inDegrees.push_back(0);
+    if(reverseIndexed) inEdges.push_back({});
     verticesN++;
 }
 
@@ -616,33 +1172,65 @@ template <class T_vertices, class T_edges>
 void ListGraph<T_vertices, T_edges>::delVertex(unsigned vertex)
 {
     assert(vertex<verticesN);
-    vertices.erase(vertices.begin()+vertex); //erasing vertex (with data)
+    this->version++;
+    vertices.erase(vertex); //erasing vertex (only the last payload is moved)
+    if(reverseIndexed)
+    {
+        delIndexedVertex(vertex);
+        return;
+    }
     //deleting data in all edges FROM vertex
     for(auto i = edges[vertex].begin(); i < edges[vertex].end(); i++)
     {
-        delete (*i).data;
+        (*i).data.destroy();
     }
     edges.erase(edges.begin()+vertex); //erasing row from the connectivity list
     verticesN--;
-    //deleting data in all edges TO vertex, decrement all next vertices
-    unsigned currLen;
+    //deleting data in all edges TO vertex, decrement all next vertices (every row is compacted in one pass)
     for(unsigned i=0; i<verticesN; i++)
     {
-        currLen = edges[i].size();
-        for(unsigned j=0; j<currLen; j++)
+        unsigned kept = 0;
+        for(unsigned j=0; j<edges[i].size(); j++)
         {
             if(edges[i][j].vertex==vertex)
             {
-                delete edges[i][j].data;
-                edges[i].erase(edges[i].begin()+j);
-                j--;
-                currLen--;
-            }
-            else if(edges[i][j].vertex>vertex)
-            {
-                edges[i][j].vertex--;
+                edges[i][j].data.destroy();
+                continue;
             }
+            if(edges[i][j].vertex>vertex) edges[i][j].vertex--;
+            edges[i][kept++] = edges[i][j];
         }
+        edges[i].resize(kept);
+    }
+    rebuildReverse();
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::delIndexedVertex(unsigned vertex)
+{
+    //edges FROM vertex leave reverse rows of their targets
+    for(auto &i : edges[vertex])
+    {
+        i.data.destroy();
+        inDegrees[i.vertex]--;
+        if(i.vertex!=vertex) removeIn(i.vertex, i.back);
+    }
+    //edges TO vertex leave rows of their sources
+    for(auto &i : inEdges[vertex])
+    {
+        if(i.vertex==vertex) continue;
+        edges[i.vertex][i.back].data.destroy();
+        removeOut(i.vertex, i.back);
+    }
+    edges.erase(edges.begin()+vertex);
+    inEdges.erase(inEdges.begin()+vertex);
+    inDegrees.erase(inDegrees.begin()+vertex);
+    verticesN--;
+    //numbers of all next vertices are decremented (plain pass, cross links stay valid)
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        for(auto &j : edges[i]) if(j.vertex>vertex) j.vertex--;
+        for(auto &j : inEdges[i]) if(j.vertex>vertex) j.vertex--;
     }
 }
 
@@ -651,24 +1239,221 @@ void ListGraph<T_vertices, T_edges>::addEdge(unsigned from, unsigned to, const T
 {
     assert(from<verticesN && to<verticesN);
     assert(!this->isEdgeExists(from, to));
-    edges[from].push_back({to, new T_edges(data)});
+    this->version++;
+    appendEdge(from, to, data);
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::appendEdge(unsigned from, unsigned to, const T_edges &data)
+{
+    edge added;
+    added.vertex = to;
+    added.back = 0;
+    added.data.create(data);
+    if(reverseIndexed)
+    {
+        added.back = inEdges[to].size();
+        inEdges[to].push_back({from, (unsigned)edges[from].size()});
+    }
+    edges[from].push_back(added);
+    inDegrees[to]++;
 }
 
 template <class T_vertices, class T_edges>
 void ListGraph<T_vertices, T_edges>::delEdge(unsigned from, unsigned to)
 {
     assert(from<verticesN && to<verticesN);
-    unsigned currLen = edges[from].size();
-    for(unsigned i=0; i<currLen; i++)
+    this->version++;
+    unsigned position = edges[from].size();
+    if(reverseIndexed && inEdges[to].size()<edges[from].size())
     {
-        if(edges[from][i].vertex==to)
+        //the shorter of two rows is searched
+        for(auto &i : inEdges[to])
         {
-            delete edges[from][i].data;
-            edges[from].erase(edges[from].begin()+i);
-            return;
+            if(i.vertex==from)
+            {
+                position = i.back;
+                break;
+            }
         }
     }
-    assert(false);
+    else
+    {
+        for(unsigned i=0; i<edges[from].size(); i++)
+        {
+            if(edges[from][i].vertex==to)
+            {
+                position = i;
+                break;
+            }
+        }
+    }
+    assert(position<edges[from].size());
+    edges[from][position].data.destroy();
+    if(reverseIndexed) removeIn(to, edges[from][position].back);
+    removeOut(from, position);
+    inDegrees[to]--;
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::removeOut(unsigned from, unsigned position)
+{
+    std::vector<edge> &row = edges[from];
+    if(orderInsensitive)
+    {
+        if(position+1!=row.size())
+        {
+            row[position] = row.back();
+            if(reverseIndexed) inEdges[row[position].vertex][row[position].back].back = position;
+        }
+        row.pop_back();
+        return;
+    }
+    row.erase(row.begin()+position);
+    if(reverseIndexed)
+    {
+        for(unsigned i=position; i<row.size(); i++) inEdges[row[i].vertex][row[i].back].back = i;
+    }
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::removeIn(unsigned to, unsigned position)
+{
+    std::vector<inEdge> &row = inEdges[to];
+    if(position+1!=row.size())
+    {
+        row[position] = row.back();
+        edges[row[position].vertex][row[position].back].back = position;
+    }
+    row.pop_back();
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::rebuildReverse()
+{
+    inDegrees.assign(verticesN, 0);
+    for(auto &i : edges)
+    {
+        for(auto &j : i) inDegrees[j.vertex]++;
+    }
+    inEdges.clear();
+    if(!reverseIndexed) return;
+    inEdges.resize(verticesN);
+    for(unsigned i=0; i<verticesN; i++) inEdges[i].reserve(inDegrees[i]);
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        for(unsigned j=0; j<edges[i].size(); j++)
+        {
+            edges[i][j].back = inEdges[edges[i][j].vertex].size();
+            inEdges[edges[i][j].vertex].push_back({i, j});
+        }
+    }
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::applyBatch(const std::vector<EdgeInsert<T_edges>> &inserts, const std::vector<EdgeDelete> &deletes)
+{
+    this->version++;
+    //deletes are grouped by row, every row is compacted in one pass
+    std::vector<EdgeDelete> sorted = deletes;
+    std::sort(sorted.begin(), sorted.end(), [](const EdgeDelete &a, const EdgeDelete &b)
+    {
+        return a.from<b.from || (a.from==b.from && a.to<b.to);
+    });
+    for(unsigned first=0, last; first<sorted.size(); first=last)
+    {
+        unsigned from = sorted[first].from;
+        assert(from<verticesN);
+        for(last=first; last<sorted.size() && sorted[last].from==from; last++);
+        auto deleted = [&](unsigned to)
+        {
+            return std::binary_search(sorted.begin()+first, sorted.begin()+last, EdgeDelete{from, to},
+                                      [](const EdgeDelete &a, const EdgeDelete &b){ return a.to<b.to; });
+        };
+        std::vector<edge> &row = edges[from];
+        unsigned kept = 0;
+        for(unsigned j=0; j<row.size(); j++)
+        {
+            if(deleted(row[j].vertex))
+            {
+                row[j].data.destroy();
+                inDegrees[row[j].vertex]--;
+                if(reverseIndexed) removeIn(row[j].vertex, row[j].back);
+                continue;
+            }
+            row[kept] = row[j];
+            if(reverseIndexed) inEdges[row[kept].vertex][row[kept].back].back = kept;
+            kept++;
+        }
+        assert(row.size()-kept==last-first); //every deleted edge existed
+        row.resize(kept);
+    }
+    //inserts are grouped by row (keeping their order), rows grow once
+    std::vector<unsigned> order(inserts.size());
+    for(unsigned i=0; i<order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&inserts](unsigned a, unsigned b){ return inserts[a].from<inserts[b].from; });
+    for(unsigned first=0, last; first<order.size(); first=last)
+    {
+        unsigned from = inserts[order[first]].from;
+        assert(from<verticesN);
+        for(last=first; last<order.size() && inserts[order[last]].from==from; last++);
+        edges[from].reserve(edges[from].size()+last-first);
+        for(unsigned i=first; i<last; i++)
+        {
+            const EdgeInsert<T_edges> &added = inserts[order[i]];
+            assert(added.to<verticesN);
+            assert(!this->isEdgeExists(from, added.to));
+            appendEdge(from, added.to, added.data);
+        }
+    }
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::applyBatch(const EdgeBatch<T_edges> &batch)
+{
+    applyBatch(batch.inserts, batch.deletes);
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::setOrderInsensitive(bool enabled)
+{
+    orderInsensitive = enabled;
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::enableReverseIndex()
+{
+    if(reverseIndexed) return;
+    reverseIndexed = true;
+    rebuildReverse();
+}
+
+template <class T_vertices, class T_edges>
+void ListGraph<T_vertices, T_edges>::disableReverseIndex()
+{
+    reverseIndexed = false;
+    inEdges.clear();
+    inEdges.shrink_to_fit();
+}
+
+template <class T_vertices, class T_edges>
+bool ListGraph<T_vertices, T_edges>::hasReverseIndex() const
+{
+    return reverseIndexed;
+}
+
+template <class T_vertices, class T_edges>
+unsigned ListGraph<T_vertices, T_edges>::outDegree(unsigned vertex) const
+{
+    assert(vertex<verticesN);
+    return edges[vertex].size();
+}
+
+template <class T_vertices, class T_edges>
+unsigned ListGraph<T_vertices, T_edges>::inDegree(unsigned vertex) const
+{
+    assert(vertex<verticesN);
+    return inDegrees[vertex];
 }
 
 template <class T_vertices, class T_edges>
@@ -705,23 +1490,6 @@ std::vector<std::vector<unsigned>> ListGraph<T_vertices, T_edges>::getEdges() co
     return res;
 }
 
-template <class T_vertices, class T_edges>
-std::vector<std::vector<unsigned>> ListGraph<T_vertices, T_edges>::getList() const
-{
-    std::vector<std::vector<unsigned>> res;
-    unsigned currLen;
-    for(unsigned i=0; i<verticesN; i++)
-    {
-        res.emplace_back();
-        currLen = edges[i].size();
-        for(unsigned j=0; j<currLen; j++)
-        {
-            res.back().push_back(edges[i][j].vertex);
-        }
-    }
-    return res;
-}
-
 template <class T_vertices, class T_edges>
 std::string ListGraph<T_vertices, T_edges>::toString() const
 {
@@ -744,40 +1512,22 @@ template <class T_vertices, class T_edges>
 bool ListGraph<T_vertices, T_edges>::stronglyConnected() const
 {
     assert(verticesN>0);
-    auto list = this->getList();
-    if(!DFS(0, list)) return false;
-    std::vector<std::vector<unsigned>> list2(verticesN);
-    unsigned currLen;
-    for(unsigned i=0; i<verticesN; i++)
-    {
-        currLen = edges[i].size();
-        for(unsigned j=0; j<currLen; j++)
-        {
-            list2[edges[i][j].vertex].push_back(i);
-        }
-    }
-    return DFS(0, list2);
+    bool res;
+    if(this->cache.findStrongly(this->version, res)) return res;
+    res = reverseIndexed ? isStronglyConnected(*this, reversedView(*this)) : isStronglyConnected(*this);
+    this->cache.storeStrongly(this->version, res);
+    return res;
 }
 
 template <class T_vertices, class T_edges>
 bool ListGraph<T_vertices, T_edges>::weaklyConnected() const
 {
     assert(verticesN>0);
-    auto list = this->getList();
-    unsigned currLen;
-    for(unsigned i=0; i<verticesN; i++)
-    {
-        currLen = list[i].size();
-        for(unsigned j=0; j<currLen; j++)
-        {
-            if(!this->isEdgeExists(list[i][j],i))
-            {
-                list[list[i][j]].push_back(i);
-            }
-        }
-    }
-    if(!DFS(0, list)) return false;
-    return true;
+    bool res;
+    if(this->cache.findWeakly(this->version, res)) return res;
+    res = reverseIndexed ? isWeaklyConnected(*this, reversedView(*this)) : isWeaklyConnected(*this);
+    this->cache.storeWeakly(this->version, res);
+    return res;
 }
 
 template <class T_vertices, class T_edges>
@@ -785,35 +1535,144 @@ std::vector<unsigned> ListGraph<T_vertices, T_edges>::getPathVertices(unsigned f
 {
     assert(from!=to);
     std::vector<unsigned> route;
-    std::vector<unsigned*> prev = this->BFS(from, to);
-    unsigned curr;
-    if(prev[to])
-    {
-        route.push_back(to);
-        curr = *prev[to];
-        while(curr!=from)
-        {
-            route.push_back(curr);
-            curr = *prev[curr];
-        }
-        route.push_back(from);
-    }
-    for(auto &i: prev) delete i;
-    std::reverse(route.begin(), route.end());
+    if(this->cache.findPath(this->version, from, to, route)) return route;
+    route = pathVertices(*this, from, to);
+    this->cache.storePath(this->version, from, to, route);
     return route;
 }
 
 template <class T_vertices, class T_edges>
-ListGraph<T_vertices, T_edges>& ListGraph<T_vertices, T_edges>::operator=(const ListGraph<T_vertices, T_edges> &toCopy)
+unsigned ListGraph<T_vertices, T_edges>::getPathLength(unsigned from, unsigned to) const
 {
-    Graph<T_vertices, T_edges>::operator=(toCopy);
-    return *this;
+    assert(from!=to);
+    if(!this->cache.enabled()) return pathLength(*this, from, to);
+    std::vector<unsigned> route;
+    if(!this->cache.findPath(this->version, from, to, route))
+    {
+        route = pathVertices(*this, from, to); //the route is stored, so later length and route queries hit
+        this->cache.storePath(this->version, from, to, route);
+    }
+    return route.empty() ? 0 : route.size()-1;
 }
 
 template <class T_vertices, class T_edges>
-ListGraph<T_vertices, T_edges>& ListGraph<T_vertices, T_edges>::operator=(const MatrixGraph<T_vertices, T_edges> &toCopy)
+std::vector<unsigned> ListGraph<T_vertices, T_edges>::stronglyConnectedComponents() const
 {
-    Graph<T_vertices, T_edges>::operator=(toCopy);
+    if(reverseIndexed) return strongComponents(*this, reversedView(*this)); //no transposed copy
+    return strongComponents(*this);
+}
+
+template <class T_vertices, class T_edges>
+unsigned long long ListGraph<T_vertices, T_edges>::countTriangles() const
+{
+    return ::countTriangles(*this); //merge while sparse, bit rows once dense
+}
+
+template <class T_vertices, class T_edges>
+std::vector<double> ListGraph<T_vertices, T_edges>::clusteringCoefficients() const
+{
+    return ::clusteringCoefficients(*this);
+}
+
+template <class T_vertices, class T_edges>
+std::vector<unsigned> ListGraph<T_vertices, T_edges>::reorder(ReorderStrategy strategy)
+{
+    this->version++;
+    std::vector<unsigned> order = vertexOrder(*this, strategy);
+    std::vector<unsigned> permutation(verticesN);
+    for(unsigned i=0; i<verticesN; i++) permutation[order[i]] = i;
+    //rows are moved, vertex payloads and edge data stay in place
+    vertices.permute(order);
+    std::vector<std::vector<edge>> newEdges(verticesN);
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        newEdges[i] = std::move(edges[order[i]]);
+        for(auto &j : newEdges[i]) j.vertex = permutation[j.vertex];
+        std::sort(newEdges[i].begin(), newEdges[i].end(), [](const edge &a, const edge &b){ return a.vertex<b.vertex; });
+    }
+    edges = std::move(newEdges);
+    rebuildReverse();
+    return permutation;
+}
+
+template <class T_vertices, class T_edges>
+template <class Function>
+void ListGraph<T_vertices, T_edges>::forEachOut(unsigned vertex, const Function &function) const
+{
+    assert(vertex<verticesN);
+    for(auto &i : edges[vertex]) function(i.vertex);
+}
+
+template <class T_vertices, class T_edges>
+template <class Function>
+void ListGraph<T_vertices, T_edges>::forEachIn(unsigned vertex, const Function &function) const
+{
+    assert(vertex<verticesN);
+    assert(reverseIndexed);
+    for(auto &i : inEdges[vertex]) function(i.vertex);
+}
+
+template <class T_vertices, class T_edges>
+template <class Function>
+void ListGraph<T_vertices, T_edges>::forEachOutEdge(unsigned vertex, const Function &function) const
+{
+    assert(vertex<verticesN);
+    for(auto &i : edges[vertex]) function(i.vertex, i.data.get());
+}
+
+template <class T_vertices, class T_edges>
+template <class A>
+VertexAttribute<A> ListGraph<T_vertices, T_edges>::addVertexAttribute(const A &initial)
+{
+    return vertices.addAttribute(initial);
+}
+
+template <class T_vertices, class T_edges>
+template <class A>
+A& ListGraph<T_vertices, T_edges>::vertexAttribute(VertexAttribute<A> attribute, unsigned vertex)
+{
+    assert(vertex<verticesN);
+    return vertices.attribute(attribute, vertex);
+}
+
+template <class T_vertices, class T_edges>
+template <class A>
+const A& ListGraph<T_vertices, T_edges>::vertexAttribute(VertexAttribute<A> attribute, unsigned vertex) const
+{
+    assert(vertex<verticesN);
+    return vertices.attribute(attribute, vertex);
+}
+
+template <class T_vertices, class T_edges>
+CompressedGraph ListGraph<T_vertices, T_edges>::compress() const
+{
+    return CompressedGraph(*this);
+}
+
+template <class T_vertices, class T_edges>
+ListGraph<T_vertices, T_edges>& ListGraph<T_vertices, T_edges>::operator=(const ListGraph<T_vertices, T_edges> &toCopy)
+{
+    //same representation is copied row by row, without virtual calls per element
+    if(this==&toCopy) return *this;
+    this->clear();
+    vertices = toCopy.vertices;
+    verticesN = toCopy.verticesN;
+    edges = toCopy.edges;
+    inDegrees = toCopy.inDegrees;
+    inEdges = toCopy.inEdges;
+    orderInsensitive = toCopy.orderInsensitive;
+    reverseIndexed = toCopy.reverseIndexed;
+    for(auto &i : edges)
+    {
+        for(auto &j : i) j.data.copy();
+    }
+    return *this;
+}
+
+template <class T_vertices, class T_edges>
+ListGraph<T_vertices, T_edges>& ListGraph<T_vertices, T_edges>::operator=(const MatrixGraph<T_vertices, T_edges> &toCopy)
+{
+    Graph<T_vertices, T_edges>::operator=(toCopy);
     return *this;
 }
 
@@ -838,10 +1697,10 @@ T_edges& ListGraph<T_vertices, T_edges>::operator()(unsigned from, unsigned to)
     unsigned currLen = edges[from].size();
     for(unsigned i=0; i<currLen; i++)
     {
-        if(edges[from][i].vertex==to) return *edges[from][i].data;
+        if(edges[from][i].vertex==to) return edges[from][i].data.get();
     }
     assert(false);
-    return *edges[0][0].data; //can't be reached
+    return edges[0][0].data.get(); //can't be reached
 }
 
 
@@ -852,10 +1711,565 @@ const T_edges& ListGraph<T_vertices, T_edges>::operator()(unsigned from, unsigne
     unsigned currLen = edges[from].size();
     for(unsigned i=0; i<currLen; i++)
     {
-        if(edges[from][i].vertex==to) return *edges[from][i].data;
+        if(edges[from][i].vertex==to) return edges[from][i].data.get();
+    }
+    assert(false);
+    return edges[0][0].data.get(); //can't be reached
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class AdaptiveGraph
+
+template <class T_vertices, class T_edges>
+template <class Function>
+decltype(auto) AdaptiveGraph<T_vertices, T_edges>::active(const Function &function) const
+{
+    if(dense) return function(matrix);
+    return function(list);
+}
+
+template <class T_vertices, class T_edges>
+template <class Function>
+decltype(auto) AdaptiveGraph<T_vertices, T_edges>::active(const Function &function)
+{
+    if(dense) return function(matrix);
+    return function(list);
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::adapt()
+{
+    unsigned n = this->size();
+    if(n<minVertices) return;
+    double density = (double)edgesN/((double)n*n);
+    if(!dense && density>=toMatrixDensity) toMatrix();
+    else if(dense && density<=toListDensity) toList();
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::toMatrix()
+{
+    unsigned n = list.verticesN;
+    matrix.vertices = std::move(list.vertices);
+    matrix.edges.assign(n, std::vector<EdgePayload<T_edges>>(n));
+    matrix.present.assign(n, BitRow((n+63)/64, 0));
+    for(unsigned i=0; i<n; i++)
+    {
+        for(auto &j : list.edges[i])
+        {
+            matrix.edges[i][j.vertex] = j.data;
+            setBit(matrix.present[i], j.vertex);
+        }
+    }
+    matrix.verticesN = n;
+    matrix.version++;
+    list.vertices.clear();
+    list.edges.clear();
+    list.inDegrees.clear();
+    list.inEdges.clear();
+    list.verticesN = 0;
+    list.version++;
+    dense = true;
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::toList()
+{
+    unsigned n = matrix.verticesN;
+    list.vertices = std::move(matrix.vertices);
+    list.edges.assign(n, {});
+    for(unsigned i=0; i<n; i++)
+    {
+        forEachBit(matrix.present[i], [&](unsigned j){ list.edges[i].push_back({j, 0, matrix.edges[i][j]}); });
+    }
+    list.verticesN = n;
+    list.rebuildReverse();
+    list.version++;
+    matrix.vertices.clear();
+    matrix.edges.clear();
+    matrix.present.clear();
+    matrix.verticesN = 0;
+    matrix.version++;
+    dense = false;
+}
+
+template <class T_vertices, class T_edges>
+AdaptiveGraph<T_vertices, T_edges>::AdaptiveGraph(double toMatrixDensity, double toListDensity, unsigned minVertices)
+{
+    assert(toListDensity<toMatrixDensity); //gap between thresholds prevents switching back and forth
+    this->toMatrixDensity = toMatrixDensity;
+    this->toListDensity = toListDensity;
+    this->minVertices = minVertices;
+    edgesN = 0;
+    dense = false;
+}
+
+template <class T_vertices, class T_edges>
+AdaptiveGraph<T_vertices, T_edges>::AdaptiveGraph(const AdaptiveGraph<T_vertices, T_edges> &toCopy)
+    : AdaptiveGraph(toCopy.toMatrixDensity, toCopy.toListDensity, toCopy.minVertices)
+{
+    *this = toCopy;
+}
+
+template <class T_vertices, class T_edges>
+bool AdaptiveGraph<T_vertices, T_edges>::isDense() const
+{
+    return dense;
+}
+
+template <class T_vertices, class T_edges>
+unsigned long long AdaptiveGraph<T_vertices, T_edges>::edgesCount() const
+{
+    return edgesN;
+}
+
+template <class T_vertices, class T_edges>
+template <class Function>
+void AdaptiveGraph<T_vertices, T_edges>::forEachOut(unsigned vertex, const Function &function) const
+{
+    active([&](auto &graph){ graph.forEachOut(vertex, function); });
+}
+
+template <class T_vertices, class T_edges>
+template <class A>
+VertexAttribute<A> AdaptiveGraph<T_vertices, T_edges>::addVertexAttribute(const A &initial)
+{
+    return active([&](auto &graph){ return graph.addVertexAttribute(initial); });
+}
+
+template <class T_vertices, class T_edges>
+template <class A>
+A& AdaptiveGraph<T_vertices, T_edges>::vertexAttribute(VertexAttribute<A> attribute, unsigned vertex)
+{
+    return active([&](auto &graph) -> A& { return graph.vertexAttribute(attribute, vertex); });
+}
+
+template <class T_vertices, class T_edges>
+template <class A>
+const A& AdaptiveGraph<T_vertices, T_edges>::vertexAttribute(VertexAttribute<A> attribute, unsigned vertex) const
+{
+    return active([&](auto &graph) -> const A& { return graph.vertexAttribute(attribute, vertex); });
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::clear()
+{
+    this->version++;
+    active([](auto &graph){ graph.clear(); });
+    edgesN = 0;
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::addVertex(const T_vertices &data)
+{
+    this->version++;
+    active([&](auto &graph){ graph.addVertex(data); });
+    adapt();
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::delVertex(unsigned vertex)
+{
+    assert(vertex<this->size());
+    this->version++;
+    //edges of deleted vertex are counted before it is gone
+    unsigned n = this->size();
+    for(unsigned i=0; i<n; i++)
+    {
+        if(this->isEdgeExists(vertex, i)) edgesN--;
+        if(i!=vertex && this->isEdgeExists(i, vertex)) edgesN--;
+    }
+    active([&](auto &graph){ graph.delVertex(vertex); });
+    adapt();
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::addEdge(unsigned from, unsigned to, const T_edges &data)
+{
+    this->version++;
+    active([&](auto &graph){ graph.addEdge(from, to, data); });
+    edgesN++;
+    adapt();
+}
+
+template <class T_vertices, class T_edges>
+void AdaptiveGraph<T_vertices, T_edges>::delEdge(unsigned from, unsigned to)
+{
+    this->version++;
+    active([&](auto &graph){ graph.delEdge(from, to); });
+    edgesN--;
+    adapt();
+}
+
+template <class T_vertices, class T_edges>
+bool AdaptiveGraph<T_vertices, T_edges>::isEdgeExists(unsigned from, unsigned to) const
+{
+    return active([&](auto &graph){ return graph.isEdgeExists(from, to); });
+}
+
+template <class T_vertices, class T_edges>
+unsigned AdaptiveGraph<T_vertices, T_edges>::size() const
+{
+    return active([&](auto &graph){ return graph.size(); });
+}
+
+template <class T_vertices, class T_edges>
+std::vector<std::vector<unsigned>> AdaptiveGraph<T_vertices, T_edges>::getEdges() const
+{
+    return active([&](auto &graph){ return graph.getEdges(); });
+}
+
+template <class T_vertices, class T_edges>
+std::string AdaptiveGraph<T_vertices, T_edges>::toString() const
+{
+    return active([&](auto &graph){ return graph.toString(); });
+}
+
+template <class T_vertices, class T_edges>
+bool AdaptiveGraph<T_vertices, T_edges>::stronglyConnected() const
+{
+    bool res;
+    if(this->cache.findStrongly(this->version, res)) return res;
+    res = active([&](auto &graph){ return graph.stronglyConnected(); });
+    this->cache.storeStrongly(this->version, res);
+    return res;
+}
+
+template <class T_vertices, class T_edges>
+bool AdaptiveGraph<T_vertices, T_edges>::weaklyConnected() const
+{
+    bool res;
+    if(this->cache.findWeakly(this->version, res)) return res;
+    res = active([&](auto &graph){ return graph.weaklyConnected(); });
+    this->cache.storeWeakly(this->version, res);
+    return res;
+}
+
+template <class T_vertices, class T_edges>
+std::vector<unsigned> AdaptiveGraph<T_vertices, T_edges>::getPathVertices(unsigned from, unsigned to) const
+{
+    std::vector<unsigned> route;
+    if(this->cache.findPath(this->version, from, to, route)) return route;
+    route = active([&](auto &graph){ return graph.getPathVertices(from, to); });
+    this->cache.storePath(this->version, from, to, route);
+    return route;
+}
+
+template <class T_vertices, class T_edges>
+std::vector<unsigned> AdaptiveGraph<T_vertices, T_edges>::stronglyConnectedComponents() const
+{
+    return active([&](auto &graph){ return graph.stronglyConnectedComponents(); });
+}
+
+template <class T_vertices, class T_edges>
+unsigned long long AdaptiveGraph<T_vertices, T_edges>::countTriangles() const
+{
+    return active([&](auto &graph){ return graph.countTriangles(); });
+}
+
+template <class T_vertices, class T_edges>
+std::vector<double> AdaptiveGraph<T_vertices, T_edges>::clusteringCoefficients() const
+{
+    return active([&](auto &graph){ return graph.clusteringCoefficients(); });
+}
+
+template <class T_vertices, class T_edges>
+AdaptiveGraph<T_vertices, T_edges>& AdaptiveGraph<T_vertices, T_edges>::operator=(const AdaptiveGraph<T_vertices, T_edges> &toCopy)
+{
+    //both representations are copied as they are (with vertex attributes), thresholds are kept
+    if(this==&toCopy) return *this;
+    this->version++;
+    list = toCopy.list;
+    matrix = toCopy.matrix;
+    edgesN = toCopy.edgesN;
+    dense = toCopy.dense;
+    return *this;
+}
+
+template <class T_vertices, class T_edges>
+AdaptiveGraph<T_vertices, T_edges>& AdaptiveGraph<T_vertices, T_edges>::operator=(const Graph<T_vertices, T_edges> &toCopy)
+{
+    Graph<T_vertices, T_edges>::operator=(toCopy);
+    return *this;
+}
+
+template <class T_vertices, class T_edges>
+T_vertices& AdaptiveGraph<T_vertices, T_edges>::operator()(unsigned vertex)
+{
+    return active([&](auto &graph) -> decltype(auto) { return graph(vertex); });
+}
+
+template <class T_vertices, class T_edges>
+const T_vertices& AdaptiveGraph<T_vertices, T_edges>::operator()(unsigned vertex) const
+{
+    return active([&](auto &graph) -> decltype(auto) { return graph(vertex); });
+}
+
+template <class T_vertices, class T_edges>
+T_edges& AdaptiveGraph<T_vertices, T_edges>::operator()(unsigned from, unsigned to)
+{
+    return active([&](auto &graph) -> decltype(auto) { return graph(from, to); });
+}
+
+template <class T_vertices, class T_edges>
+const T_edges& AdaptiveGraph<T_vertices, T_edges>::operator()(unsigned from, unsigned to) const
+{
+    return active([&](auto &graph) -> decltype(auto) { return graph(from, to); });
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class ListGraphSnapshot
+
+template <class T_vertices, class T_edges>
+const typename ListGraphSnapshot<T_vertices, T_edges>::row& ListGraphSnapshot<T_vertices, T_edges>::getRow(unsigned vertex) const
+{
+    assert(vertex<verticesN);
+    return *chunks[vertex>>chunkBits]->rows[vertex&(chunkSize-1)];
+}
+
+template <class T_vertices, class T_edges>
+unsigned long long ListGraphSnapshot<T_vertices, T_edges>::version() const
+{
+    return versionN;
+}
+
+template <class T_vertices, class T_edges>
+unsigned ListGraphSnapshot<T_vertices, T_edges>::size() const
+{
+    return verticesN;
+}
+
+template <class T_vertices, class T_edges>
+bool ListGraphSnapshot<T_vertices, T_edges>::isEdgeExists(unsigned from, unsigned to) const
+{
+    assert(from<verticesN && to<verticesN);
+    for(auto &i : getRow(from).edges)
+    {
+        if(i.vertex==to) return true;
+    }
+    return false;
+}
+
+template <class T_vertices, class T_edges>
+std::vector<std::vector<unsigned>> ListGraphSnapshot<T_vertices, T_edges>::getEdges() const
+{
+    std::vector<std::vector<unsigned>> res;
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        for(auto &j : getRow(i).edges) res.push_back({i,j.vertex});
+    }
+    return res;
+}
+
+template <class T_vertices, class T_edges>
+std::vector<unsigned> ListGraphSnapshot<T_vertices, T_edges>::getPathVertices(unsigned from, unsigned to) const
+{
+    return pathVertices(*this, from, to);
+}
+
+template <class T_vertices, class T_edges>
+template <class Function>
+void ListGraphSnapshot<T_vertices, T_edges>::forEachOut(unsigned vertex, const Function &function) const
+{
+    for(auto &i : getRow(vertex).edges) function(i.vertex);
+}
+
+template <class T_vertices, class T_edges>
+const T_vertices& ListGraphSnapshot<T_vertices, T_edges>::operator()(unsigned vertex) const
+{
+    return *getRow(vertex).data;
+}
+
+template <class T_vertices, class T_edges>
+const T_edges& ListGraphSnapshot<T_vertices, T_edges>::operator()(unsigned from, unsigned to) const
+{
+    assert(from<verticesN && to<verticesN);
+    for(auto &i : getRow(from).edges)
+    {
+        if(i.vertex==to) return *i.data;
     }
     assert(false);
-    return *edges[0][0].data; //can't be reached
+    return *getRow(0).edges[0].data; //can't be reached
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class ConcurrentListGraph
+
+template <class T_vertices, class T_edges>
+ConcurrentListGraph<T_vertices, T_edges>::ConcurrentListGraph()
+{
+    published = std::make_shared<snapshot_t>();
+    published->versionN = 0;
+    published->verticesN = 0;
+}
+
+template <class T_vertices, class T_edges>
+ConcurrentListGraph<T_vertices, T_edges>::ConcurrentListGraph(const ListGraph<T_vertices, T_edges> &toCopy) : ConcurrentListGraph()
+{
+    for(unsigned i=0; i<toCopy.size(); i++)
+    {
+        addVertex(toCopy(i));
+    }
+    for(auto &i : toCopy.getEdges())
+    {
+        mutableRow(i[0]).edges.push_back({i[1], std::make_shared<const T_edges>(toCopy(i[0], i[1]))});
+    }
+    publish();
+}
+
+template <class T_vertices, class T_edges>
+typename ConcurrentListGraph<T_vertices, T_edges>::snapshot_t& ConcurrentListGraph<T_vertices, T_edges>::getPending()
+{
+    if(!pending)
+    {
+        pending = std::make_shared<snapshot_t>(*published); //copies only pointers to chunks
+        pending->versionN++;
+    }
+    return *pending;
+}
+
+template <class T_vertices, class T_edges>
+typename ConcurrentListGraph<T_vertices, T_edges>::snapshot_t::row& ConcurrentListGraph<T_vertices, T_edges>::mutableRow(unsigned vertex)
+{
+    snapshot_t &curr = getPending();
+    assert(vertex<curr.verticesN);
+    auto &currChunk = curr.chunks[vertex>>snapshot_t::chunkBits];
+    if(currChunk->generation!=curr.versionN)
+    {
+        currChunk = std::make_shared<typename snapshot_t::chunk>(*currChunk);
+        currChunk->generation = curr.versionN;
+    }
+    auto &currRow = currChunk->rows[vertex&(snapshot_t::chunkSize-1)];
+    if(currRow->generation!=curr.versionN)
+    {
+        currRow = std::make_shared<typename snapshot_t::row>(*currRow);
+        currRow->generation = curr.versionN;
+    }
+    return *currRow;
+}
+
+template <class T_vertices, class T_edges>
+void ConcurrentListGraph<T_vertices, T_edges>::addVertex(const T_vertices &data)
+{
+    snapshot_t &curr = getPending();
+    if((curr.verticesN&(snapshot_t::chunkSize-1))==0)
+    {
+        curr.chunks.push_back(std::make_shared<typename snapshot_t::chunk>());
+        curr.chunks.back()->generation = curr.versionN;
+    }
+    curr.verticesN++;
+    auto &currChunk = curr.chunks.back();
+    if(currChunk->generation!=curr.versionN)
+    {
+        currChunk = std::make_shared<typename snapshot_t::chunk>(*currChunk);
+        currChunk->generation = curr.versionN;
+    }
+    currChunk->rows.push_back(std::make_shared<typename snapshot_t::row>());
+    currChunk->rows.back()->data = std::make_shared<const T_vertices>(data);
+    currChunk->rows.back()->generation = curr.versionN;
+}
+
+template <class T_vertices, class T_edges>
+void ConcurrentListGraph<T_vertices, T_edges>::delVertex(unsigned vertex)
+{
+    snapshot_t &curr = getPending();
+    assert(vertex<curr.verticesN);
+    //numbers of all next vertices are shifted, so all chunks are rebuilt (rows without such edges are still shared)
+    std::vector<std::shared_ptr<typename snapshot_t::row>> rows;
+    for(unsigned i=0; i<curr.verticesN; i++)
+    {
+        if(i!=vertex) rows.push_back(curr.chunks[i>>snapshot_t::chunkBits]->rows[i&(snapshot_t::chunkSize-1)]);
+    }
+    curr.verticesN--;
+    curr.chunks.clear();
+    for(unsigned i=0; i<curr.verticesN; i++)
+    {
+        auto &currRow = rows[i];
+        bool affected = false;
+        for(auto &j : currRow->edges)
+        {
+            if(j.vertex>=vertex) affected = true;
+        }
+        if(affected)
+        {
+            if(currRow->generation!=curr.versionN)
+            {
+                currRow = std::make_shared<typename snapshot_t::row>(*currRow);
+                currRow->generation = curr.versionN;
+            }
+            auto &currEdges = currRow->edges;
+            currEdges.erase(std::remove_if(currEdges.begin(), currEdges.end(),
+                [vertex](const typename snapshot_t::edge &e){ return e.vertex==vertex; }), currEdges.end());
+            for(auto &j : currEdges)
+            {
+                if(j.vertex>vertex) j.vertex--;
+            }
+        }
+        if((i&(snapshot_t::chunkSize-1))==0)
+        {
+            curr.chunks.push_back(std::make_shared<typename snapshot_t::chunk>());
+            curr.chunks.back()->generation = curr.versionN;
+        }
+        curr.chunks.back()->rows.push_back(currRow);
+    }
+}
+
+template <class T_vertices, class T_edges>
+void ConcurrentListGraph<T_vertices, T_edges>::addEdge(unsigned from, unsigned to, const T_edges &data)
+{
+    assert(to<getPending().verticesN);
+    auto &currEdges = mutableRow(from).edges;
+    assert(std::none_of(currEdges.begin(), currEdges.end(), [to](const typename snapshot_t::edge &e){ return e.vertex==to; }));
+    currEdges.push_back({to, std::make_shared<const T_edges>(data)});
+}
+
+template <class T_vertices, class T_edges>
+void ConcurrentListGraph<T_vertices, T_edges>::delEdge(unsigned from, unsigned to)
+{
+    auto &currEdges = mutableRow(from).edges;
+    for(auto i = currEdges.begin(); i < currEdges.end(); i++)
+    {
+        if((*i).vertex==to)
+        {
+            currEdges.erase(i);
+            return;
+        }
+    }
+    assert(false);
+}
+
+template <class T_vertices, class T_edges>
+void ConcurrentListGraph<T_vertices, T_edges>::setVertex(unsigned vertex, const T_vertices &data)
+{
+    mutableRow(vertex).data = std::make_shared<const T_vertices>(data);
+}
+
+template <class T_vertices, class T_edges>
+void ConcurrentListGraph<T_vertices, T_edges>::setEdge(unsigned from, unsigned to, const T_edges &data)
+{
+    for(auto &i : mutableRow(from).edges)
+    {
+        if(i.vertex==to)
+        {
+            i.data = std::make_shared<const T_edges>(data);
+            return;
+        }
+    }
+    assert(false);
+}
+
+template <class T_vertices, class T_edges>
+void ConcurrentListGraph<T_vertices, T_edges>::publish()
+{
+    if(!pending) return;
+    std::atomic_store(&published, pending);
+    pending = nullptr;
+}
+
+template <class T_vertices, class T_edges>
+std::shared_ptr<const ListGraphSnapshot<T_vertices, T_edges>> ConcurrentListGraph<T_vertices, T_edges>::snapshot() const
+{
+    return std::atomic_load(&published);
 }
 
 #endif
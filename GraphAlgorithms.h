@@ -0,0 +1,2345 @@
+#ifndef GRAPH_ALGORITHMS_H
+#define GRAPH_ALGORITHMS_H
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cassert>
+#include <queue>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cmath>
+#include <type_traits>
+#include <cstring>
+#include "EdgeStorage.h"
+
+//---------------------------------------------------------------------------------------------------------------//
+// parallel helpers
+
+inline unsigned hardwareThreads() //returns number of worker threads to use (at least 1)
+{
+    unsigned n = std::thread::hardware_concurrency();
+    if(n==0) return 1;
+    return n;
+}
+
+template <class Function>
+void parallelFor(unsigned begin, unsigned end, const Function &function, unsigned chunk = 1024)
+    //calls function(i) for every i in [begin, end), chunks of indices are shared between all cores
+{
+    if(begin>=end) return;
+    std::atomic<unsigned> next{begin};
+    auto worker = [&]()
+    {
+        while(true)
+        {
+            unsigned first = next.fetch_add(chunk);
+            if(first>=end || first<begin) return; //second check catches overflow of next
+            unsigned last = std::min(end, first+chunk);
+            if(last<first) last = end;
+            for(unsigned i=first; i<last; i++) function(i);
+        }
+    };
+    unsigned threadsN = std::min(hardwareThreads(), (end-begin-1)/chunk+1);
+    std::vector<std::thread> threads;
+    for(unsigned i=1; i<threadsN; i++) threads.emplace_back(worker);
+    worker();
+    for(auto &i : threads) i.join();
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// adjacency arrays
+
+//graph concept used by all algorithms below (checked at compile time, calls are inlined):
+//    unsigned size() const;                                   - number of vertices
+//    template <class F> void forEachOut(unsigned v, const F &f) const;   - calls f(u) for every edge v-->u
+//algorithms which generate graphs also need addVertex(data) and addEdge(from, to, data)
+
+struct AdjacencyArrays //flat read-only adjacency: targets of vertex v are targets[offsets[v]..offsets[v+1])
+{
+    std::vector<unsigned> offsets{0};
+    std::vector<unsigned> targets;
+
+    unsigned size() const
+    {
+        return offsets.size()-1;
+    }
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const
+    {
+        for(unsigned i=offsets[vertex]; i<offsets[vertex+1]; i++) function(targets[i]);
+    }
+};
+
+template <class G>
+struct ReversedView //graph with reversed edges over a graph which has forEachIn (nothing is copied)
+{
+    const G &graph;
+
+    unsigned size() const
+    {
+        return graph.size();
+    }
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const
+    {
+        graph.forEachIn(vertex, function);
+    }
+};
+
+template <class G>
+ReversedView<G> reversedView(const G &graph)
+{
+    return ReversedView<G>{graph};
+}
+
+template <class G>
+AdjacencyArrays transposed(const G &graph) //returns arrays of reversed edges
+{
+    unsigned verticesN = graph.size();
+    AdjacencyArrays res;
+    res.offsets.assign(verticesN+1, 0);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        graph.forEachOut(v, [&res](unsigned u){ res.offsets[u+1]++; });
+    }
+    for(unsigned v=0; v<verticesN; v++) res.offsets[v+1] += res.offsets[v];
+    res.targets.resize(res.offsets[verticesN]);
+    std::vector<unsigned> pos(res.offsets.begin(), res.offsets.end()-1);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        graph.forEachOut(v, [&](unsigned u){ res.targets[pos[u]++] = v; });
+    }
+    return res;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// subgraph views
+
+struct AllEdges //edge predicate which keeps every edge
+{
+    template <class T_edges>
+    bool operator()(unsigned, unsigned, const T_edges&) const
+    {
+        return true;
+    }
+};
+
+template <class G, class EdgePredicate = AllEdges>
+struct SubgraphView;
+
+template <class G>
+bool containsVertex(const G &, unsigned) //vertices of plain graphs are never hidden
+{
+    return true;
+}
+
+template <class G, class EdgePredicate>
+bool containsVertex(const SubgraphView<G, EdgePredicate> &view, unsigned vertex)
+{
+    return view.contains(vertex);
+}
+
+//vertices with mask[v]==false and edges with predicate(from, to, data)==false are hidden (nothing is copied)
+//numbers of vertices are kept, hidden vertices are isolated and connectivity checks skip them
+//views can be nested, vertices hidden by the inner view stay hidden in the outer one
+//mask and graph must outlive the view, edge predicate needs forEachOutEdge of the graph
+template <class G, class EdgePredicate>
+struct SubgraphView
+{
+    const G &graph;
+    const std::vector<bool> *mask; //nullptr keeps all vertices
+    EdgePredicate predicate;
+
+    unsigned size() const
+    {
+        return graph.size();
+    }
+    bool contains(unsigned vertex) const
+    {
+        return inMask(vertex) && containsVertex(graph, vertex);
+    }
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const
+    {
+        if(!inMask(vertex)) return; //the inner graph skips its own hidden vertices
+        visit(vertex, function, std::is_same<EdgePredicate, AllEdges>());
+    }
+    template <class Function>
+    void forEachOutEdge(unsigned vertex, const Function &function) const
+    {
+        if(!inMask(vertex)) return;
+        graph.forEachOutEdge(vertex, [&](unsigned u, const auto &data)
+        {
+            if(inMask(u) && predicate(vertex, u, data)) function(u, data);
+        });
+    }
+private:
+    bool inMask(unsigned vertex) const //checks only the own mask
+    {
+        return !mask || (*mask)[vertex];
+    }
+    template <class Function>
+    void visit(unsigned vertex, const Function &function, std::true_type) const //only the mask is checked
+    {
+        graph.forEachOut(vertex, [&](unsigned u)
+        {
+            if(inMask(u)) function(u);
+        });
+    }
+    template <class Function>
+    void visit(unsigned vertex, const Function &function, std::false_type) const
+    {
+        forEachOutEdge(vertex, [&function](unsigned u, const auto&){ function(u); });
+    }
+};
+
+template <class G>
+SubgraphView<G> subgraphView(const G &graph, const std::vector<bool> &mask) //induced subgraph of vertices with mask[v]
+{
+    assert(mask.size()==graph.size());
+    return SubgraphView<G>{graph, &mask, AllEdges()};
+}
+
+template <class G, class EdgePredicate>
+SubgraphView<G, EdgePredicate> subgraphView(const G &graph, const std::vector<bool> &mask, const EdgePredicate &predicate)
+{
+    assert(mask.size()==graph.size());
+    return SubgraphView<G, EdgePredicate>{graph, &mask, predicate};
+}
+
+template <class G, class EdgePredicate>
+SubgraphView<G, EdgePredicate> filteredView(const G &graph, const EdgePredicate &predicate) //all vertices, edges with predicate
+{
+    return SubgraphView<G, EdgePredicate>{graph, nullptr, predicate};
+}
+
+template <class G>
+unsigned presentVertices(const G &graph) //number of vertices connectivity checks have to reach
+{
+    return graph.size();
+}
+
+template <class G, class EdgePredicate>
+unsigned presentVertices(const SubgraphView<G, EdgePredicate> &view)
+{
+    if(!view.mask) return presentVertices(view.graph);
+    unsigned res = 0;
+    for(unsigned v=0; v<view.size(); v++)
+    {
+        if(view.contains(v)) res++;
+    }
+    return res;
+}
+
+template <class G>
+unsigned firstPresentVertex(const G &)
+{
+    return 0;
+}
+
+template <class G, class EdgePredicate>
+unsigned firstPresentVertex(const SubgraphView<G, EdgePredicate> &view)
+{
+    unsigned vertex = 0;
+    while(vertex<view.size() && !view.contains(vertex)) vertex++;
+    return vertex;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// traversals, paths and connectivity
+
+template <class G, class Function>
+void breadthFirst(const G &graph, unsigned start, const Function &function) //calls function(v) for every reached vertex
+{
+    assert(start<graph.size());
+    std::vector<bool> visited(graph.size(), false);
+    std::vector<unsigned> queue{start};
+    visited[start] = true;
+    for(unsigned head=0; head<queue.size(); head++)
+    {
+        function(queue[head]);
+        graph.forEachOut(queue[head], [&](unsigned u)
+        {
+            if(!visited[u])
+            {
+                visited[u] = true;
+                queue.push_back(u);
+            }
+        });
+    }
+}
+
+template <class G, class Function>
+void depthFirst(const G &graph, unsigned start, const Function &function) //calls function(v) for every reached vertex
+{
+    assert(start<graph.size());
+    std::vector<bool> visited(graph.size(), false);
+    std::vector<unsigned> stack{start};
+    while(!stack.empty())
+    {
+        unsigned curr = stack.back();
+        stack.pop_back();
+        if(visited[curr]) continue;
+        visited[curr] = true;
+        function(curr);
+        graph.forEachOut(curr, [&](unsigned u)
+        {
+            if(!visited[u]) stack.push_back(u);
+        });
+    }
+}
+
+struct TraversalStep
+{
+    unsigned vertex;
+    unsigned depth; //number of edges from start in the traversal tree
+    unsigned parent; //previous vertex in the traversal tree (start is its own parent)
+};
+
+template <class Cursor>
+class CursorIterator //input iterator over steps of a cursor, used by range-based for
+{
+private:
+    Cursor *cursor; //nullptr at the end
+    TraversalStep step;
+public:
+    explicit CursorIterator(Cursor *cursor) : cursor(cursor)
+    {
+        ++*this;
+    }
+    const TraversalStep& operator*() const
+    {
+        return step;
+    }
+    CursorIterator& operator++()
+    {
+        if(cursor && !cursor->next(step)) cursor = nullptr;
+        return *this;
+    }
+    bool operator!=(const CursorIterator &other) const
+    {
+        return cursor!=other.cursor;
+    }
+};
+
+//lazy traversals: every next() returns one more vertex, a row is scanned only when the search has to go past it
+//a cursor can be left at any moment, iterating it again continues from the first vertex not returned yet
+template <class G>
+class BreadthFirstCursor
+{
+private:
+    const G &graph;
+    std::vector<unsigned> parents; //none for vertices not discovered yet
+    std::vector<unsigned> depths;
+    std::vector<unsigned> queue; //discovered vertices in BFS order
+    unsigned head; //next vertex of queue to return
+    unsigned expanded; //vertices queue[0..expanded) have their rows scanned
+public:
+    BreadthFirstCursor(const G &graph, unsigned start);
+    bool next(TraversalStep &step); //false when all reachable vertices were returned
+    bool discovered(unsigned vertex) const; //checks if vertex is already queued or returned
+    CursorIterator<BreadthFirstCursor<G>> begin() {return CursorIterator<BreadthFirstCursor<G>>(this);}
+    CursorIterator<BreadthFirstCursor<G>> end() {return CursorIterator<BreadthFirstCursor<G>>(nullptr);}
+};
+
+template <class G>
+class DepthFirstCursor
+{
+private:
+    const G &graph;
+    std::vector<bool> visited;
+    std::vector<TraversalStep> stack; //candidates, the last one is returned next if it is not visited
+    TraversalStep last; //returned vertex whose row is not scanned yet
+    bool pending; //last has to be expanded
+public:
+    DepthFirstCursor(const G &graph, unsigned start);
+    bool next(TraversalStep &step); //false when all reachable vertices were returned
+    bool discovered(unsigned vertex) const; //checks if vertex is already returned
+    CursorIterator<DepthFirstCursor<G>> begin() {return CursorIterator<DepthFirstCursor<G>>(this);}
+    CursorIterator<DepthFirstCursor<G>> end() {return CursorIterator<DepthFirstCursor<G>>(nullptr);}
+};
+
+template <class G>
+BreadthFirstCursor<G>::BreadthFirstCursor(const G &graph, unsigned start)
+    : graph(graph), parents(graph.size(), std::numeric_limits<unsigned>::max()), depths(graph.size(), 0)
+{
+    assert(start<graph.size());
+    parents[start] = start;
+    queue.push_back(start);
+    head = 0;
+    expanded = 0;
+}
+
+template <class G>
+bool BreadthFirstCursor<G>::next(TraversalStep &step)
+{
+    //rows are scanned only until there is something to return
+    while(head==queue.size() && expanded<head)
+    {
+        unsigned curr = queue[expanded++];
+        graph.forEachOut(curr, [&](unsigned u)
+        {
+            if(parents[u]==std::numeric_limits<unsigned>::max())
+            {
+                parents[u] = curr;
+                depths[u] = depths[curr]+1;
+                queue.push_back(u);
+            }
+        });
+    }
+    if(head==queue.size()) return false;
+    unsigned curr = queue[head++];
+    step = {curr, depths[curr], parents[curr]};
+    return true;
+}
+
+template <class G>
+bool BreadthFirstCursor<G>::discovered(unsigned vertex) const
+{
+    return parents[vertex]!=std::numeric_limits<unsigned>::max();
+}
+
+template <class G>
+DepthFirstCursor<G>::DepthFirstCursor(const G &graph, unsigned start) : graph(graph), visited(graph.size(), false)
+{
+    assert(start<graph.size());
+    stack.push_back({start, 0, start});
+    pending = false;
+}
+
+template <class G>
+bool DepthFirstCursor<G>::next(TraversalStep &step)
+{
+    if(pending)
+    {
+        //row of the previous vertex is scanned now, when the search goes deeper
+        pending = false;
+        graph.forEachOut(last.vertex, [&](unsigned u)
+        {
+            if(!visited[u]) stack.push_back({u, last.depth+1, last.vertex});
+        });
+    }
+    while(!stack.empty() && visited[stack.back().vertex]) stack.pop_back();
+    if(stack.empty()) return false;
+    last = stack.back();
+    stack.pop_back();
+    visited[last.vertex] = true;
+    pending = true;
+    step = last;
+    return true;
+}
+
+template <class G>
+bool DepthFirstCursor<G>::discovered(unsigned vertex) const
+{
+    return visited[vertex];
+}
+
+template <class G>
+BreadthFirstCursor<G> breadthFirstCursor(const G &graph, unsigned start)
+{
+    return BreadthFirstCursor<G>(graph, start);
+}
+
+template <class G>
+DepthFirstCursor<G> depthFirstCursor(const G &graph, unsigned start)
+{
+    return DepthFirstCursor<G>(graph, start);
+}
+
+template <class G>
+std::vector<unsigned> pathVertices(const G &graph, unsigned from, unsigned to) //returns vertices chain between 2 vertices [from-->to]
+{
+    unsigned verticesN = graph.size();
+    assert(from<verticesN && to<verticesN);
+    assert(from!=to);
+    const unsigned none = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> prev(verticesN, none);
+    std::vector<unsigned> queue{from};
+    prev[from] = from;
+    for(unsigned head=0; head<queue.size() && prev[to]==none; head++)
+    {
+        unsigned curr = queue[head];
+        graph.forEachOut(curr, [&](unsigned u)
+        {
+            if(prev[u]==none)
+            {
+                prev[u] = curr;
+                queue.push_back(u);
+            }
+        });
+    }
+    std::vector<unsigned> route;
+    if(prev[to]==none) return route;
+    for(unsigned curr=to; curr!=from; curr=prev[curr]) route.push_back(curr);
+    route.push_back(from);
+    std::reverse(route.begin(), route.end());
+    return route;
+}
+
+template <class G>
+unsigned pathLength(const G &graph, unsigned from, unsigned to) //returns number of edges between 2 vertices (or 0, if disconnected)
+{
+    unsigned length = pathVertices(graph, from, to).size();
+    if(length==0) return 0;
+    return length-1;
+}
+
+template <class G>
+unsigned reachedCount(const G &graph, unsigned start) //returns number of vertices reachable from start (with start)
+{
+    unsigned reached = 0;
+    depthFirst(graph, start, [&reached](unsigned){ reached++; });
+    return reached;
+}
+
+template <class G>
+bool reachesAll(const G &graph, unsigned start) //checks if all vertices are reachable from start
+{
+    return reachedCount(graph, start)==presentVertices(graph);
+}
+
+template <class G, class R>
+bool isStronglyConnected(const G &graph, const R &reversed) //reversed must be graph with reversed edges
+{
+    unsigned present = presentVertices(graph), start = firstPresentVertex(graph);
+    assert(present>0);
+    return reachedCount(graph, start)==present && reachedCount(reversed, start)==present;
+}
+
+template <class G>
+bool isStronglyConnected(const G &graph)
+{
+    unsigned present = presentVertices(graph), start = firstPresentVertex(graph);
+    assert(present>0);
+    return reachedCount(graph, start)==present && reachedCount(transposed(graph), start)==present;
+}
+
+template <class G, class R>
+bool isWeaklyConnected(const G &graph, const R &reversed) //reversed must be graph with reversed edges
+{
+    unsigned present = presentVertices(graph), start = firstPresentVertex(graph);
+    assert(present>0);
+    std::vector<bool> visited(graph.size(), false);
+    std::vector<unsigned> stack{start};
+    unsigned reached = 0;
+    visited[start] = true;
+    auto visit = [&](unsigned u)
+    {
+        if(!visited[u])
+        {
+            visited[u] = true;
+            stack.push_back(u);
+        }
+    };
+    while(!stack.empty())
+    {
+        unsigned curr = stack.back();
+        stack.pop_back();
+        reached++;
+        graph.forEachOut(curr, visit);
+        reversed.forEachOut(curr, visit);
+    }
+    return reached==present;
+}
+
+template <class G>
+bool isWeaklyConnected(const G &graph)
+{
+    return isWeaklyConnected(graph, transposed(graph));
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// generation
+
+template <class G, class T_vertices, class T_edges, class Engine>
+void randomFill(G &graph, unsigned verticesN, double edgeProb, const T_vertices &verticesData, const T_edges &edgesData, Engine &engine)
+    //adds verticesN vertices, then every ordered pair of new vertices gets an edge with probability edgeProb
+{
+    assert(edgeProb>=0 && edgeProb<=1);
+    std::uniform_real_distribution<double> randDouble(0, 1);
+    unsigned first = graph.size();
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        graph.addVertex(verticesData);
+    }
+    unsigned last = first+verticesN;
+    for(unsigned i=first; i<last; i++)
+    {
+        for(unsigned j=first; j<last; j++)
+        {
+            if(randDouble(engine)<edgeProb) graph.addEdge(i, j, edgesData);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// batches of edge changes
+
+template <class T_edges>
+struct EdgeInsert
+{
+    unsigned from;
+    unsigned to;
+    T_edges data;
+};
+
+struct EdgeDelete
+{
+    unsigned from;
+    unsigned to;
+};
+
+template <class T_edges>
+struct EdgeBatch //deletes are applied before inserts, so an edge can be replaced in one batch
+{
+    std::vector<EdgeInsert<T_edges>> inserts;
+    std::vector<EdgeDelete> deletes;
+};
+
+//returns changes which turn graph a into graph b (graphs must have the same number of vertices)
+//edges with different data (compared by ==) are deleted and inserted again, O(V+E)
+template <class G1, class G2>
+auto diff(const G1 &a, const G2 &b) -> EdgeBatch<typename std::decay<decltype(b(0u, 0u))>::type>
+{
+    typedef typename std::decay<decltype(b(0u, 0u))>::type T_edges;
+    unsigned verticesN = a.size();
+    assert(b.size()==verticesN);
+    EdgeBatch<T_edges> res;
+    std::vector<unsigned> stamp(verticesN, 0); //v+1 for targets of row v in b which are not matched yet
+    std::vector<const T_edges*> dataB(verticesN);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        b.forEachOutEdge(v, [&](unsigned u, const T_edges &data)
+        {
+            stamp[u] = v+1;
+            dataB[u] = &data;
+        });
+        a.forEachOutEdge(v, [&](unsigned u, const T_edges &data)
+        {
+            if(stamp[u]!=v+1)
+            {
+                res.deletes.push_back({v, u});
+                return;
+            }
+            stamp[u] = 0;
+            if(!(data==*dataB[u]))
+            {
+                res.deletes.push_back({v, u});
+                res.inserts.push_back({v, u, *dataB[u]});
+            }
+        });
+        b.forEachOutEdge(v, [&](unsigned u, const T_edges &data)
+        {
+            if(stamp[u]==v+1) res.inserts.push_back({v, u, data});
+        });
+    }
+    return res;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// strongly connected components
+
+//reversed must be graph with reversed edges (e.g. transposed(graph)), returns component id of every vertex
+//trimming, forward-backward pass for the giant component, then coloring rounds for the rest (all phases are parallel)
+template <class G, class R>
+std::vector<unsigned> strongComponents(const G &graph, const R &reversed)
+{
+    unsigned verticesN = graph.size();
+    const unsigned none = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> component(verticesN, none);
+    std::atomic<unsigned> componentsN{0};
+
+    //trimming: vertex without in- or out-edges inside the unresolved part is a component by itself
+    //removed vertices are appended to queue, every level of removals is processed in parallel
+    std::unique_ptr<std::atomic<unsigned>[]> inDegree(new std::atomic<unsigned>[verticesN]);
+    std::unique_ptr<std::atomic<unsigned>[]> outDegree(new std::atomic<unsigned>[verticesN]);
+    std::unique_ptr<std::atomic<bool>[]> trimmed(new std::atomic<bool>[verticesN]);
+    parallelFor(0, verticesN, [&](unsigned v)
+    {
+        unsigned in = 0, out = 0;
+        graph.forEachOut(v, [&](unsigned u){ if(u!=v) out++; });
+        reversed.forEachOut(v, [&](unsigned u){ if(u!=v) in++; });
+        inDegree[v].store(in, std::memory_order_relaxed);
+        outDegree[v].store(out, std::memory_order_relaxed);
+        trimmed[v].store(false, std::memory_order_relaxed);
+    });
+    std::vector<unsigned> queue(verticesN);
+    std::atomic<unsigned> tail{0};
+    parallelFor(0, verticesN, [&](unsigned v)
+    {
+        if(inDegree[v].load(std::memory_order_relaxed)==0 || outDegree[v].load(std::memory_order_relaxed)==0)
+        {
+            trimmed[v].store(true, std::memory_order_relaxed);
+            queue[tail++] = v;
+        }
+    });
+    auto release = [&](std::atomic<unsigned> &degree, unsigned u) //removes one edge of u, queues u when it is trimmed
+    {
+        if(trimmed[u].load(std::memory_order_relaxed)) return;
+        if(degree.fetch_sub(1, std::memory_order_relaxed)==1 && !trimmed[u].exchange(true, std::memory_order_relaxed))
+        {
+            queue[tail++] = u;
+        }
+    };
+    for(unsigned begin=0, end=tail.load(); begin<end; begin=end, end=tail.load())
+    {
+        parallelFor(begin, end, [&](unsigned i)
+        {
+            unsigned curr = queue[i];
+            component[curr] = componentsN++;
+            graph.forEachOut(curr, [&](unsigned u){ if(u!=curr) release(inDegree[u], u); });
+            reversed.forEachOut(curr, [&](unsigned u){ if(u!=curr) release(outDegree[u], u); });
+        }, 256);
+    }
+    std::vector<unsigned> rest;
+    unsigned pivot = none;
+    unsigned long long pivotRank = 0;
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        if(component[v]!=none) continue;
+        rest.push_back(v);
+        unsigned long long rank = (unsigned long long)inDegree[v].load(std::memory_order_relaxed)*
+                                  outDegree[v].load(std::memory_order_relaxed);
+        if(pivot==none || rank>pivotRank)
+        {
+            pivot = v;
+            pivotRank = rank;
+        }
+    }
+
+    //forward-backward from the vertex with the largest degrees: usually resolves the giant component at once
+    //both searches are level-synchronous, vertices of a level are expanded in parallel and claimed by atomic marks
+    if(pivot!=none)
+    {
+        std::unique_ptr<std::atomic<unsigned char>[]> mark(new std::atomic<unsigned char>[verticesN]);
+        parallelFor(0, verticesN, [&](unsigned v){ mark[v].store(0, std::memory_order_relaxed); });
+        auto search = [&](const auto &edges, unsigned char bit)
+        {
+            mark[pivot].fetch_or(bit, std::memory_order_relaxed);
+            queue[0] = pivot;
+            tail.store(1);
+            for(unsigned begin=0, end=1; begin<end; begin=end, end=tail.load())
+            {
+                parallelFor(begin, end, [&](unsigned i)
+                {
+                    edges.forEachOut(queue[i], [&](unsigned u)
+                    {
+                        if(component[u]!=none || (mark[u].load(std::memory_order_relaxed)&bit)) return;
+                        if(!(mark[u].fetch_or(bit, std::memory_order_relaxed)&bit)) queue[tail++] = u;
+                    });
+                }, 256);
+            }
+        };
+        search(graph, 1);
+        search(reversed, 2);
+        unsigned id = componentsN++;
+        unsigned restN = 0;
+        for(unsigned v : rest)
+        {
+            if(mark[v].load(std::memory_order_relaxed)==3) component[v] = id;
+            else rest[restN++] = v;
+        }
+        rest.resize(restN);
+    }
+
+    //coloring: every vertex takes the largest id among vertices reaching it,
+    //then every vertex which kept its own id collects its component backwards among vertices of its color
+    std::unique_ptr<std::atomic<unsigned>[]> color(new std::atomic<unsigned>[verticesN]);
+    while(!rest.empty())
+    {
+        parallelFor(0, rest.size(), [&](unsigned i)
+        {
+            color[rest[i]].store(rest[i], std::memory_order_relaxed);
+        });
+        std::atomic<bool> changed{true};
+        while(changed.load())
+        {
+            changed.store(false);
+            parallelFor(0, rest.size(), [&](unsigned i)
+            {
+                unsigned curr = color[rest[i]].load(std::memory_order_relaxed);
+                graph.forEachOut(rest[i], [&](unsigned u)
+                {
+                    if(component[u]!=none) return;
+                    unsigned old = color[u].load(std::memory_order_relaxed);
+                    while(old<curr)
+                    {
+                        if(color[u].compare_exchange_weak(old, curr, std::memory_order_relaxed))
+                        {
+                            changed.store(true, std::memory_order_relaxed);
+                            break;
+                        }
+                    }
+                });
+            });
+        }
+        std::vector<unsigned> roots;
+        for(unsigned v : rest)
+        {
+            if(color[v].load(std::memory_order_relaxed)==v) roots.push_back(v);
+        }
+        parallelFor(0, roots.size(), [&](unsigned i)
+        {
+            unsigned root = roots[i];
+            unsigned id = componentsN++;
+            std::vector<unsigned> rootStack{root};
+            component[root] = id;
+            while(!rootStack.empty())
+            {
+                unsigned curr = rootStack.back();
+                rootStack.pop_back();
+                reversed.forEachOut(curr, [&](unsigned u)
+                {
+                    if(color[u].load(std::memory_order_relaxed)==root && component[u]==none)
+                    {
+                        component[u] = id;
+                        rootStack.push_back(u);
+                    }
+                });
+            }
+        }, 1);
+        unsigned restN = 0;
+        for(unsigned v : rest)
+        {
+            if(component[v]==none) rest[restN++] = v;
+        }
+        rest.resize(restN);
+    }
+
+    //renumbering components in order of their smallest vertex
+    std::vector<unsigned> renumber(componentsN, none);
+    unsigned next = 0;
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        if(renumber[component[v]]==none) renumber[component[v]] = next++;
+        component[v] = renumber[component[v]];
+    }
+    return component;
+}
+
+template <class G>
+std::vector<unsigned> strongComponents(const G &graph) //returns component id of every vertex
+{
+    return strongComponents(graph, transposed(graph));
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// vertex orderings
+
+enum class ReorderStrategy
+{
+    reverseCuthillMcKee, //BFS from low degree vertices, neighbours by increasing degree, reversed (small bandwidth)
+    degree, //by decreasing degree (hubs together)
+    bfs, //BFS order (neighbours get close numbers)
+    gorderLite //greedy: next vertex shares most neighbours with the last few placed ones
+};
+
+//returns old numbers of vertices in their new order, edges are treated as undirected
+template <class G>
+std::vector<unsigned> vertexOrder(const G &graph, ReorderStrategy strategy)
+{
+    unsigned verticesN = graph.size();
+    AdjacencyArrays reversed = transposed(graph);
+    std::vector<unsigned> order;
+    order.reserve(verticesN);
+    std::vector<unsigned> degree(verticesN, 0), outDegree(verticesN, 0);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        graph.forEachOut(v, [&](unsigned u)
+        {
+            outDegree[v]++;
+            degree[v]++;
+            degree[u]++;
+        });
+    }
+    auto neighbours = [&](unsigned v, const auto &f)
+    {
+        graph.forEachOut(v, f);
+        reversed.forEachOut(v, f);
+    };
+    switch(strategy)
+    {
+        case ReorderStrategy::degree:
+        {
+            for(unsigned v=0; v<verticesN; v++) order.push_back(v);
+            std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b){ return degree[a]>degree[b]; });
+            break;
+        }
+        case ReorderStrategy::bfs:
+        case ReorderStrategy::reverseCuthillMcKee:
+        {
+            bool rcm = strategy==ReorderStrategy::reverseCuthillMcKee;
+            std::vector<bool> visited(verticesN, false);
+            std::vector<unsigned> starts;
+            for(unsigned v=0; v<verticesN; v++) starts.push_back(v);
+            if(rcm) std::stable_sort(starts.begin(), starts.end(), [&](unsigned a, unsigned b){ return degree[a]<degree[b]; });
+            std::vector<unsigned> next;
+            for(unsigned start : starts)
+            {
+                if(visited[start]) continue;
+                visited[start] = true;
+                unsigned head = order.size();
+                order.push_back(start);
+                while(head<order.size())
+                {
+                    unsigned curr = order[head++];
+                    next.clear();
+                    neighbours(curr, [&](unsigned u)
+                    {
+                        if(!visited[u])
+                        {
+                            visited[u] = true;
+                            next.push_back(u);
+                        }
+                    });
+                    if(rcm) std::stable_sort(next.begin(), next.end(), [&](unsigned a, unsigned b){ return degree[a]<degree[b]; });
+                    order.insert(order.end(), next.begin(), next.end());
+                }
+            }
+            if(rcm) std::reverse(order.begin(), order.end());
+            break;
+        }
+        case ReorderStrategy::gorderLite:
+        {
+            //score of vertex = number of neighbours and siblings (common in-neighbour) inside the window of last placed vertices
+            const unsigned window = 5;
+            const unsigned hubDegree = std::max(16u, (unsigned)std::sqrt((double)verticesN)); //siblings through hubs are ignored
+            std::vector<unsigned> score(verticesN, 0);
+            std::vector<bool> placed(verticesN, false);
+            std::priority_queue<std::pair<unsigned, unsigned>> heap; //(score, vertex), may hold outdated entries
+            auto update = [&](unsigned v, bool add)
+            {
+                auto change = [&](unsigned u)
+                {
+                    if(placed[u]) return;
+                    if(add) score[u]++;
+                    else score[u]--;
+                    heap.push({score[u], u});
+                };
+                neighbours(v, change);
+                reversed.forEachOut(v, [&](unsigned w)
+                {
+                    if(outDegree[w]<=hubDegree) graph.forEachOut(w, [&](unsigned u){ if(u!=v) change(u); });
+                });
+            };
+            unsigned scan = 0; //smallest vertex which may be still not placed
+            while(order.size()<verticesN)
+            {
+                unsigned curr = verticesN;
+                while(!heap.empty())
+                {
+                    auto top = heap.top();
+                    heap.pop();
+                    if(!placed[top.second] && score[top.second]==top.first && top.first>0)
+                    {
+                        curr = top.second;
+                        break;
+                    }
+                }
+                if(curr==verticesN)
+                {
+                    if(order.empty())
+                    {
+                        curr = 0;
+                        for(unsigned v=1; v<verticesN; v++)
+                        {
+                            if(degree[v]-outDegree[v]>degree[curr]-outDegree[curr]) curr = v;
+                        }
+                    }
+                    else
+                    {
+                        while(placed[scan]) scan++;
+                        curr = scan;
+                    }
+                }
+                placed[curr] = true;
+                order.push_back(curr);
+                update(curr, true);
+                if(order.size()>window) update(order[order.size()-window-1], false);
+            }
+            break;
+        }
+    }
+    return order;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// ranking
+
+struct PageRankOptions
+{
+    double damping = 0.85; //probability to follow an edge instead of teleporting
+    double tolerance = 1e-9; //iterations stop when sum of rank changes is below it
+    unsigned maxIterations = 100;
+};
+
+//pull iterations over contiguous in-edge arrays: rank[v] = base*teleport[v] + damping*sum(rank[u]/outDegree[u])
+//mass of vertices without out-edges is spread by teleport, so ranks always sum to 1
+//every chunk of vertices is written by one thread and its change is summed in chunk order (results do not depend on threads)
+template <class G>
+std::vector<double> pageRankIterations(const G &graph, const std::vector<double> &teleport, const PageRankOptions &options)
+{
+    unsigned verticesN = graph.size();
+    assert(teleport.size()==verticesN);
+    if(verticesN==0) return {};
+    AdjacencyArrays in = transposed(graph);
+    std::vector<double> inverseDegree(verticesN, 0);
+    for(unsigned u : in.targets) inverseDegree[u]++;
+    std::vector<unsigned> dangling;
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        if(inverseDegree[v]==0) dangling.push_back(v);
+        else inverseDegree[v] = 1/inverseDegree[v];
+    }
+
+    const unsigned chunk = 2048;
+    unsigned chunksN = (verticesN-1)/chunk+1;
+    std::vector<double> rank = teleport, next(verticesN), contribution(verticesN), change(chunksN);
+    const unsigned *offsets = in.offsets.data(), *sources = in.targets.data();
+    for(unsigned iteration=0; iteration<options.maxIterations; iteration++)
+    {
+        double danglingMass = 0;
+        for(unsigned v : dangling) danglingMass += rank[v];
+        double base = 1-options.damping+options.damping*danglingMass;
+        parallelFor(0, chunksN, [&](unsigned c)
+        {
+            unsigned first = c*chunk, last = std::min(verticesN, first+chunk);
+            for(unsigned v=first; v<last; v++) contribution[v] = rank[v]*inverseDegree[v];
+        }, 1);
+        parallelFor(0, chunksN, [&](unsigned c)
+        {
+            unsigned first = c*chunk, last = std::min(verticesN, first+chunk);
+            const double *from = contribution.data();
+            double sum = 0;
+            for(unsigned v=first; v<last; v++)
+            {
+                //4 independent accumulators, so the gather loop is not bound by one chain of additions
+                double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                unsigned i = offsets[v], end = offsets[v+1];
+                for(; i+4<=end; i+=4)
+                {
+                    s0 += from[sources[i]];
+                    s1 += from[sources[i+1]];
+                    s2 += from[sources[i+2]];
+                    s3 += from[sources[i+3]];
+                }
+                for(; i<end; i++) s0 += from[sources[i]];
+                next[v] = base*teleport[v]+options.damping*((s0+s1)+(s2+s3));
+                sum += std::abs(next[v]-rank[v]);
+            }
+            change[c] = sum;
+        }, 1);
+        rank.swap(next);
+        double total = 0;
+        for(double i : change) total += i;
+        if(total<options.tolerance) break;
+    }
+    return rank;
+}
+
+template <class G>
+std::vector<double> pageRank(const G &graph, const PageRankOptions &options = PageRankOptions()) //returns rank of every vertex
+{
+    unsigned verticesN = graph.size();
+    return pageRankIterations(graph, std::vector<double>(verticesN, 1.0/std::max(verticesN, 1u)), options);
+}
+
+//random jumps (and dangling mass) go only to sources, so ranks measure closeness to them
+template <class G>
+std::vector<double> personalizedPageRank(const G &graph, const std::vector<unsigned> &sources,
+                                         const PageRankOptions &options = PageRankOptions())
+{
+    assert(!sources.empty());
+    std::vector<double> teleport(graph.size(), 0);
+    for(unsigned v : sources)
+    {
+        assert(v<graph.size());
+        teleport[v] += 1.0/sources.size();
+    }
+    return pageRankIterations(graph, teleport, options);
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// triangles and clustering (edges are treated as undirected, self-loops are ignored)
+
+enum class TriangleStrategy
+{
+    automatic, //bitset when density is at least 1/64 (a row of words is cheaper than merging lists), merge otherwise
+    bitset, //AND + popcount of adjacency bit rows (dense graphs, memory verticesN^2/8 bytes)
+    merge //intersection of sorted neighbour lists (sparse graphs)
+};
+
+//symmetric arrays made by undirectedArrays, algorithms overloaded for them skip the conversion
+//(plain AdjacencyArrays, e.g. from transposed, are treated as directed graphs and converted)
+struct UndirectedArrays : public AdjacencyArrays
+{
+};
+
+template <class G>
+UndirectedArrays undirectedArrays(const G &graph) //returns sorted neighbours of every vertex without self-loops and repeats
+{
+    unsigned verticesN = graph.size();
+    UndirectedArrays res;
+    res.offsets.assign(verticesN+1, 0);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        graph.forEachOut(v, [&](unsigned u)
+        {
+            if(u==v) return;
+            res.offsets[v+1]++;
+            res.offsets[u+1]++;
+        });
+    }
+    for(unsigned v=0; v<verticesN; v++) res.offsets[v+1] += res.offsets[v];
+    res.targets.resize(res.offsets[verticesN]);
+    std::vector<unsigned> pos(res.offsets.begin(), res.offsets.end()-1);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        graph.forEachOut(v, [&](unsigned u)
+        {
+            if(u==v) return;
+            res.targets[pos[v]++] = u;
+            res.targets[pos[u]++] = v;
+        });
+    }
+    //edges in both directions give repeated neighbours, they are removed after sorting and rows are packed
+    parallelFor(0, verticesN, [&](unsigned v)
+    {
+        auto first = res.targets.begin()+res.offsets[v], last = res.targets.begin()+res.offsets[v+1];
+        std::sort(first, last);
+        pos[v] = std::unique(first, last)-res.targets.begin();
+    }, 256);
+    unsigned packed = 0;
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        unsigned begin = res.offsets[v];
+        res.offsets[v] = packed;
+        for(unsigned i=begin; i<pos[v]; i++) res.targets[packed++] = res.targets[i];
+    }
+    res.offsets[verticesN] = packed;
+    res.targets.resize(packed);
+    return res;
+}
+
+inline TriangleStrategy chooseTriangleStrategy(const UndirectedArrays &neighbours, TriangleStrategy strategy)
+{
+    if(strategy!=TriangleStrategy::automatic) return strategy;
+    double verticesN = neighbours.size();
+    if(verticesN>0 && neighbours.targets.size()*64.0>=verticesN*verticesN) return TriangleStrategy::bitset;
+    return TriangleStrategy::merge;
+}
+
+inline std::vector<BitRow> neighbourBits(const UndirectedArrays &neighbours) //adjacency bit row of every vertex
+{
+    unsigned verticesN = neighbours.size();
+    std::vector<BitRow> rows(verticesN, BitRow((verticesN+63)/64, 0));
+    parallelFor(0, verticesN, [&](unsigned v)
+    {
+        neighbours.forEachOut(v, [&](unsigned u){ setBit(rows[v], u); });
+    }, 256);
+    return rows;
+}
+
+inline unsigned commonCount(const unsigned *a, const unsigned *aEnd, const unsigned *b, const unsigned *bEnd)
+    //returns size of intersection of 2 sorted ranges
+{
+    unsigned res = 0;
+    while(a!=aEnd && b!=bEnd)
+    {
+        if(*a<*b) a++;
+        else if(*b<*a) b++;
+        else
+        {
+            res++;
+            a++;
+            b++;
+        }
+    }
+    return res;
+}
+
+//triangles through every vertex: half of common neighbours summed over all neighbours (vertices are independent)
+inline std::vector<unsigned long long> vertexTriangles(const UndirectedArrays &neighbours, TriangleStrategy strategy)
+{
+    unsigned verticesN = neighbours.size();
+    std::vector<unsigned long long> res(verticesN, 0);
+    const unsigned *offsets = neighbours.offsets.data(), *targets = neighbours.targets.data();
+    if(chooseTriangleStrategy(neighbours, strategy)==TriangleStrategy::bitset)
+    {
+        std::vector<BitRow> rows = neighbourBits(neighbours);
+        unsigned wordsN = (verticesN+63)/64;
+        parallelFor(0, verticesN, [&](unsigned v)
+        {
+            const unsigned long long *row = rows[v].data();
+            unsigned long long found = 0;
+            for(unsigned i=offsets[v]; i<offsets[v+1]; i++)
+            {
+                const unsigned long long *other = rows[targets[i]].data();
+                for(unsigned w=0; w<wordsN; w++) found += bitCount(row[w]&other[w]);
+            }
+            res[v] = found/2;
+        }, 64);
+    }
+    else
+    {
+        parallelFor(0, verticesN, [&](unsigned v)
+        {
+            unsigned long long found = 0;
+            for(unsigned i=offsets[v]; i<offsets[v+1]; i++)
+            {
+                unsigned u = targets[i];
+                found += commonCount(targets+offsets[v], targets+offsets[v+1], targets+offsets[u], targets+offsets[u+1]);
+            }
+            res[v] = found/2;
+        }, 256);
+    }
+    return res;
+}
+
+template <class G>
+std::vector<unsigned long long> vertexTriangles(const G &graph, TriangleStrategy strategy = TriangleStrategy::automatic)
+    //returns number of triangles through every vertex
+{
+    return vertexTriangles(undirectedArrays(graph), strategy);
+}
+
+//every triangle is counted once: by its lowest vertex (bitset) or along edges to higher (degree, number) vertices (merge)
+inline unsigned long long countTriangles(const UndirectedArrays &neighbours, TriangleStrategy strategy)
+{
+    unsigned verticesN = neighbours.size();
+    std::vector<unsigned long long> found(verticesN, 0);
+    const unsigned *offsets = neighbours.offsets.data(), *targets = neighbours.targets.data();
+    if(chooseTriangleStrategy(neighbours, strategy)==TriangleStrategy::bitset)
+    {
+        std::vector<BitRow> rows = neighbourBits(neighbours);
+        unsigned wordsN = (verticesN+63)/64;
+        parallelFor(0, verticesN, [&](unsigned v)
+        {
+            const unsigned long long *row = rows[v].data();
+            for(unsigned i=offsets[v]; i<offsets[v+1]; i++)
+            {
+                unsigned u = targets[i];
+                if(u<v) continue;
+                //only third vertices above u
+                const unsigned long long *other = rows[u].data();
+                unsigned w = u>>6;
+                found[v] += bitCount(row[w]&other[w]&(~1ull<<(u&63)));
+                for(w++; w<wordsN; w++) found[v] += bitCount(row[w]&other[w]);
+            }
+        }, 64);
+    }
+    else
+    {
+        //forward lists keep neighbours of higher rank, so hubs get short lists
+        auto higher = [&](unsigned a, unsigned b)
+        {
+            unsigned degreeA = offsets[a+1]-offsets[a], degreeB = offsets[b+1]-offsets[b];
+            return degreeA>degreeB || (degreeA==degreeB && a>b);
+        };
+        AdjacencyArrays forward;
+        forward.offsets.assign(verticesN+1, 0);
+        for(unsigned v=0; v<verticesN; v++)
+        {
+            neighbours.forEachOut(v, [&](unsigned u){ if(higher(u, v)) forward.offsets[v+1]++; });
+        }
+        for(unsigned v=0; v<verticesN; v++) forward.offsets[v+1] += forward.offsets[v];
+        forward.targets.resize(forward.offsets[verticesN]);
+        parallelFor(0, verticesN, [&](unsigned v)
+        {
+            unsigned pos = forward.offsets[v];
+            neighbours.forEachOut(v, [&](unsigned u){ if(higher(u, v)) forward.targets[pos++] = u; });
+        }, 256);
+        const unsigned *forwardOffsets = forward.offsets.data(), *forwardTargets = forward.targets.data();
+        parallelFor(0, verticesN, [&](unsigned v)
+        {
+            for(unsigned i=forwardOffsets[v]; i<forwardOffsets[v+1]; i++)
+            {
+                unsigned u = forwardTargets[i];
+                found[v] += commonCount(forwardTargets+forwardOffsets[v], forwardTargets+forwardOffsets[v+1],
+                                        forwardTargets+forwardOffsets[u], forwardTargets+forwardOffsets[u+1]);
+            }
+        }, 256);
+    }
+    unsigned long long res = 0;
+    for(auto i : found) res += i;
+    return res;
+}
+
+template <class G>
+unsigned long long countTriangles(const G &graph, TriangleStrategy strategy = TriangleStrategy::automatic)
+    //returns number of triangles in the graph
+{
+    return countTriangles(undirectedArrays(graph), strategy);
+}
+
+template <class G>
+std::vector<double> clusteringCoefficients(const G &graph, TriangleStrategy strategy = TriangleStrategy::automatic)
+    //returns share of connected pairs among neighbours of every vertex (0 for less than 2 neighbours)
+{
+    UndirectedArrays neighbours = undirectedArrays(graph);
+    std::vector<unsigned long long> triangles = vertexTriangles(neighbours, strategy);
+    std::vector<double> res(neighbours.size(), 0);
+    for(unsigned v=0; v<neighbours.size(); v++)
+    {
+        double degree = neighbours.offsets[v+1]-neighbours.offsets[v];
+        if(degree>=2) res[v] = 2*triangles[v]/(degree*(degree-1));
+    }
+    return res;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// k-cores (edges are treated as undirected, self-loops are ignored)
+
+//core number of v is the largest k such that v stays in the subgraph where every vertex has at least k neighbours
+//peeling with buckets of vertices by current degree (Batagelj-Zaversnik), O(V+E)
+//peelOrder (if given) gets vertices in the order of removal, every vertex has at most core number later neighbours
+inline std::vector<unsigned> coreNumbers(const UndirectedArrays &neighbours, std::vector<unsigned> *peelOrder = nullptr)
+{
+    unsigned verticesN = neighbours.size();
+    std::vector<unsigned> degree(verticesN);
+    unsigned maxDegree = 0;
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        degree[v] = neighbours.offsets[v+1]-neighbours.offsets[v];
+        maxDegree = std::max(maxDegree, degree[v]);
+    }
+    //order holds vertices sorted by degree, bucketStart[d] is the first position with degree d
+    std::vector<unsigned> bucketStart(maxDegree+2, 0), order(verticesN), position(verticesN);
+    for(unsigned v=0; v<verticesN; v++) bucketStart[degree[v]+1]++;
+    for(unsigned d=0; d<=maxDegree; d++) bucketStart[d+1] += bucketStart[d];
+    std::vector<unsigned> next(bucketStart.begin(), bucketStart.end()-1);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        position[v] = next[degree[v]]++;
+        order[position[v]] = v;
+    }
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        unsigned v = order[i]; //degree[v] is final now
+        neighbours.forEachOut(v, [&](unsigned u)
+        {
+            if(degree[u]<=degree[v]) return;
+            //u is moved to the front of its bucket, then the bucket boundary passes it
+            unsigned first = bucketStart[degree[u]], w = order[first];
+            if(w!=u)
+            {
+                std::swap(order[first], order[position[u]]);
+                position[w] = position[u];
+                position[u] = first;
+            }
+            bucketStart[degree[u]]++;
+            degree[u]--;
+        });
+    }
+    if(peelOrder) *peelOrder = std::move(order);
+    return degree;
+}
+
+template <class G>
+std::vector<unsigned> coreNumbers(const G &graph) //returns core number of every vertex
+{
+    return coreNumbers(undirectedArrays(graph));
+}
+
+//every round sets core of v to the h-index of cores of its neighbours (the largest h with h neighbours of core >= h)
+//starting from degrees the values only decrease and stop at core numbers, vertices of a round are independent
+inline std::vector<unsigned> parallelCoreNumbers(const UndirectedArrays &neighbours)
+{
+    unsigned verticesN = neighbours.size();
+    std::vector<unsigned> core(verticesN), next(verticesN);
+    for(unsigned v=0; v<verticesN; v++) core[v] = neighbours.offsets[v+1]-neighbours.offsets[v];
+    std::atomic<bool> changed{true};
+    while(changed)
+    {
+        changed = false;
+        parallelFor(0, verticesN, [&](unsigned v)
+        {
+            unsigned current = core[v];
+            //count[h] = neighbours with core >= h, cores above current are cut to current
+            thread_local std::vector<unsigned> count;
+            count.assign(current+1, 0);
+            neighbours.forEachOut(v, [&](unsigned u){ count[std::min(core[u], current)]++; });
+            unsigned h = current, atLeast = count[current];
+            while(h>0 && atLeast<h) atLeast += count[--h];
+            next[v] = h;
+            if(h!=current) changed = true;
+        }, 256);
+        core.swap(next);
+    }
+    return core;
+}
+
+template <class G>
+std::vector<unsigned> parallelCoreNumbers(const G &graph) //returns core number of every vertex (multithreaded)
+{
+    return parallelCoreNumbers(undirectedArrays(graph));
+}
+
+inline std::vector<bool> coreMask(const std::vector<unsigned> &cores, unsigned k) //vertices of the k-core (mask for subgraphView)
+{
+    std::vector<bool> res(cores.size());
+    for(unsigned v=0; v<cores.size(); v++) res[v] = cores[v]>=k;
+    return res;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// minimum spanning forest (edges are treated as undirected, weights are key(data) of T_edges)
+
+struct SpanningEdge
+{
+    unsigned from;
+    unsigned to;
+};
+
+class DisjointSets //union-find with path halving and union by size
+{
+private:
+    std::vector<unsigned> parent;
+    std::vector<unsigned> setSize;
+public:
+    explicit DisjointSets(unsigned elementsN) : parent(elementsN), setSize(elementsN, 1)
+    {
+        for(unsigned i=0; i<elementsN; i++) parent[i] = i;
+    }
+    unsigned find(unsigned element)
+    {
+        while(parent[element]!=element)
+        {
+            parent[element] = parent[parent[element]];
+            element = parent[element];
+        }
+        return element;
+    }
+    bool unite(unsigned a, unsigned b) //returns false if they were already in one set
+    {
+        a = find(a);
+        b = find(b);
+        if(a==b) return false;
+        if(setSize[a]<setSize[b]) std::swap(a, b);
+        parent[b] = a;
+        setSize[a] += setSize[b];
+        return true;
+    }
+};
+
+//maps a key to unsigned bits with the same order (radix sort and comparisons work on these bits)
+template <class K>
+typename std::enable_if<std::is_unsigned<K>::value, unsigned long long>::type orderedBits(K key)
+{
+    return key;
+}
+
+template <class K>
+typename std::enable_if<std::is_signed<K>::value && std::is_integral<K>::value, unsigned long long>::type orderedBits(K key)
+{
+    return (unsigned long long)(long long)key^(1ull<<63);
+}
+
+template <class K>
+typename std::enable_if<std::is_floating_point<K>::value, unsigned long long>::type orderedBits(K key)
+{
+    double value = key;
+    unsigned long long bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits>>63 ? ~bits : bits|(1ull<<63); //negative numbers go in reversed order below positive ones
+}
+
+struct WeightedEdges //undirected edges with ordered weight bits, edge i is (from[i], to[i])
+{
+    std::vector<unsigned> from;
+    std::vector<unsigned> to;
+    std::vector<unsigned long long> weight;
+
+    bool lighter(unsigned a, unsigned b) const //ties are broken by index, so the minimum forest is unique
+    {
+        return weight[a]<weight[b] || (weight[a]==weight[b] && a<b);
+    }
+};
+
+template <class G, class Key>
+WeightedEdges weightedEdges(const G &graph, const Key &key)
+{
+    WeightedEdges res;
+    for(unsigned v=0; v<graph.size(); v++)
+    {
+        graph.forEachOutEdge(v, [&](unsigned u, const auto &data)
+        {
+            if(u==v) return;
+            res.from.push_back(v);
+            res.to.push_back(u);
+            res.weight.push_back(orderedBits(key(data)));
+        });
+    }
+    return res;
+}
+
+inline std::vector<unsigned> radixOrder(const std::vector<unsigned long long> &keys) //stable order of indices by keys
+{
+    unsigned n = keys.size();
+    std::vector<unsigned> order(n), buffer(n);
+    for(unsigned i=0; i<n; i++) order[i] = i;
+    for(unsigned shift=0; shift<64; shift+=8)
+    {
+        unsigned count[257] = {};
+        for(unsigned i=0; i<n; i++) count[(keys[i]>>shift&255)+1]++;
+        if(count[(keys[0]>>shift&255)+1]==n) continue; //all keys have the same byte
+        for(unsigned b=0; b<256; b++) count[b+1] += count[b];
+        for(unsigned i : order) buffer[count[keys[i]>>shift&255]++] = i;
+        order.swap(buffer);
+    }
+    return order;
+}
+
+//Kruskal: edges sorted by radix sort of weight bits, cycles are rejected by union-find
+template <class G, class Key>
+std::vector<SpanningEdge> minimumSpanningForest(const G &graph, const Key &key) //key(data) gives weight of an edge
+{
+    WeightedEdges edges = weightedEdges(graph, key);
+    std::vector<SpanningEdge> res;
+    if(edges.weight.empty()) return res;
+    DisjointSets sets(graph.size());
+    for(unsigned i : radixOrder(edges.weight))
+    {
+        if(sets.unite(edges.from[i], edges.to[i])) res.push_back({edges.from[i], edges.to[i]});
+    }
+    return res;
+}
+
+//Boruvka: every round each component picks its lightest outgoing edge (in parallel over edges),
+//picked edges join components, so there are at most log(V) rounds; the result is the same as of Kruskal
+template <class G, class Key>
+std::vector<SpanningEdge> parallelMinimumSpanningForest(const G &graph, const Key &key) //key(data) gives weight of an edge
+{
+    const unsigned none = std::numeric_limits<unsigned>::max();
+    unsigned verticesN = graph.size();
+    WeightedEdges edges = weightedEdges(graph, key);
+    std::vector<unsigned> alive(edges.weight.size()); //edges between different components
+    for(unsigned i=0; i<alive.size(); i++) alive[i] = i;
+    std::vector<unsigned> component(verticesN);
+    for(unsigned v=0; v<verticesN; v++) component[v] = v;
+    std::vector<std::atomic<unsigned>> lightest(verticesN);
+    DisjointSets sets(verticesN);
+    std::vector<SpanningEdge> res;
+    while(!alive.empty())
+    {
+        for(auto &i : lightest) i.store(none, std::memory_order_relaxed);
+        auto offer = [&](unsigned c, unsigned e)
+        {
+            unsigned current = lightest[c].load(std::memory_order_relaxed);
+            while((current==none || edges.lighter(e, current)) && !lightest[c].compare_exchange_weak(current, e)) {}
+        };
+        parallelFor(0, alive.size(), [&](unsigned i)
+        {
+            unsigned e = alive[i];
+            offer(component[edges.from[e]], e);
+            offer(component[edges.to[e]], e);
+        });
+        for(unsigned c=0; c<verticesN; c++)
+        {
+            unsigned e = lightest[c].load(std::memory_order_relaxed);
+            if(e!=none && sets.unite(edges.from[e], edges.to[e])) res.push_back({edges.from[e], edges.to[e]});
+        }
+        for(unsigned v=0; v<verticesN; v++) component[v] = sets.find(v);
+        alive.erase(std::remove_if(alive.begin(), alive.end(), [&](unsigned e)
+        {
+            return component[edges.from[e]]==component[edges.to[e]];
+        }), alive.end());
+    }
+    return res;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// topological order and cycles
+
+//returns vertices of a directed cycle (edge from every vertex to the next one and from the last to the first),
+//empty for acyclic graphs; iterative DFS, out-edges of a vertex are pushed when it is entered
+template <class G>
+std::vector<unsigned> findCycle(const G &graph)
+{
+    enum {white, gray, black};
+    unsigned verticesN = graph.size();
+    std::vector<unsigned char> color(verticesN, white);
+    std::vector<unsigned> parent(verticesN);
+    std::vector<std::pair<unsigned, unsigned>> frames; //(vertex, size of pending before its out-edges)
+    std::vector<unsigned> pending;
+    for(unsigned start=0; start<verticesN; start++)
+    {
+        if(color[start]!=white) continue;
+        auto enter = [&](unsigned v)
+        {
+            color[v] = gray;
+            frames.push_back({v, (unsigned)pending.size()});
+            graph.forEachOut(v, [&pending](unsigned u){ pending.push_back(u); });
+        };
+        enter(start);
+        while(!frames.empty())
+        {
+            unsigned v = frames.back().first;
+            if(pending.size()==frames.back().second)
+            {
+                color[v] = black;
+                frames.pop_back();
+                continue;
+            }
+            unsigned u = pending.back();
+            pending.pop_back();
+            if(color[u]==white)
+            {
+                parent[u] = v;
+                enter(u);
+            }
+            else if(color[u]==gray) //u is on the stack: cycle u-->...-->v-->u
+            {
+                std::vector<unsigned> cycle;
+                for(unsigned curr=v; curr!=u; curr=parent[curr]) cycle.push_back(curr);
+                cycle.push_back(u);
+                std::reverse(cycle.begin(), cycle.end());
+                return cycle;
+            }
+        }
+    }
+    return {};
+}
+
+template <class G>
+std::vector<unsigned> inDegreeCounts(const G &graph) //returns number of edges to every vertex
+{
+    std::vector<unsigned> res(graph.size(), 0);
+    for(unsigned v=0; v<graph.size(); v++)
+    {
+        graph.forEachOut(v, [&res](unsigned u){ res[u]++; });
+    }
+    return res;
+}
+
+//Kahn's algorithm: order gets every vertex after all its predecessors, returns false if there is a cycle
+//(then order holds only vertices which are not reachable from cycles, and cycle (if given) gets one of them)
+template <class G>
+bool topologicalOrder(const G &graph, std::vector<unsigned> &order, std::vector<unsigned> *cycle = nullptr)
+{
+    unsigned verticesN = graph.size();
+    std::vector<unsigned> inDegree = inDegreeCounts(graph);
+    order.clear();
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        if(inDegree[v]==0) order.push_back(v);
+    }
+    for(unsigned head=0; head<order.size(); head++)
+    {
+        graph.forEachOut(order[head], [&](unsigned u)
+        {
+            if(--inDegree[u]==0) order.push_back(u);
+        });
+    }
+    if(order.size()==verticesN) return true;
+    if(cycle)
+    {
+        //the rest always has a cycle, it is searched only there
+        std::vector<bool> rest(verticesN, true);
+        for(unsigned v : order) rest[v] = false;
+        *cycle = findCycle(subgraphView(graph, rest));
+    }
+    return false;
+}
+
+//wavefront schedule: level 0 has vertices without in-edges, level i+1 has vertices whose predecessors are all in
+//levels up to i, so vertices of one level can be processed concurrently; returns false if there is a cycle
+//(vertices reachable from cycles are not in levels); large levels are expanded in parallel
+template <class G>
+bool topologicalLevels(const G &graph, std::vector<std::vector<unsigned>> &levels)
+{
+    unsigned verticesN = graph.size();
+    std::vector<unsigned> counted = inDegreeCounts(graph);
+    std::vector<std::atomic<unsigned>> inDegree(verticesN);
+    for(unsigned v=0; v<verticesN; v++) inDegree[v].store(counted[v], std::memory_order_relaxed);
+    levels.clear();
+    std::vector<unsigned> current;
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        if(counted[v]==0) current.push_back(v);
+    }
+    unsigned placed = 0;
+    std::vector<unsigned> next(verticesN);
+    while(!current.empty())
+    {
+        placed += current.size();
+        std::atomic<unsigned> nextN{0};
+        auto expand = [&](unsigned i)
+        {
+            graph.forEachOut(current[i], [&](unsigned u)
+            {
+                if(inDegree[u].fetch_sub(1, std::memory_order_acq_rel)==1) next[nextN++] = u;
+            });
+        };
+        if(current.size()>=4096) parallelFor(0, current.size(), expand, 256);
+        else
+        {
+            for(unsigned i=0; i<current.size(); i++) expand(i);
+        }
+        levels.push_back(std::move(current));
+        current.assign(next.begin(), next.begin()+nextN);
+        std::sort(current.begin(), current.end()); //same levels whatever the threads did
+    }
+    return placed==verticesN;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// diameter and eccentricity (edges are treated as undirected, distances are numbers of edges)
+
+class BfsWorkspace //buffers of BFS kept between runs, distances are reset by bumping the stamp (no O(V) clearing)
+{
+private:
+    std::vector<unsigned> stamp; //run which set distance of the vertex
+    std::vector<unsigned> dist;
+    std::vector<unsigned> prev; //vertex from which the vertex was reached (kept only if routes are tracked)
+    std::vector<unsigned> target; //run which marked the vertex as a target of searchTargets
+    std::vector<unsigned> queue;
+    unsigned run = 0;
+    bool routes; //keep predecessors for route()
+
+    void begin(unsigned verticesN) //starts a new run
+    {
+        if(stamp.size()!=verticesN)
+        {
+            stamp.assign(verticesN, 0);
+            target.clear();
+            dist.resize(verticesN);
+            if(routes) prev.resize(verticesN);
+            run = 0;
+        }
+        if(++run==0) //stamps overflowed
+        {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(target.begin(), target.end(), 0);
+            run = 1;
+        }
+    }
+    template <class G>
+    void explore(const G &graph, unsigned start, unsigned targetsN) //stops once targetsN marked targets are reached
+    {
+        queue.clear();
+        queue.push_back(start);
+        stamp[start] = run;
+        dist[start] = 0;
+        if(routes) prev[start] = start;
+        if(!target.empty() && target[start]==run) targetsN--;
+        for(unsigned head=0; head<queue.size() && targetsN>0; head++)
+        {
+            unsigned curr = queue[head];
+            graph.forEachOut(curr, [&](unsigned u)
+            {
+                if(stamp[u]!=run)
+                {
+                    stamp[u] = run;
+                    dist[u] = dist[curr]+1;
+                    if(routes) prev[u] = curr;
+                    queue.push_back(u);
+                    if(!target.empty() && target[u]==run) targetsN--;
+                }
+            });
+        }
+    }
+public:
+    explicit BfsWorkspace(bool routes = false) //routes - keep predecessors, so route() can be used
+        : routes(routes)
+    {}
+    template <class G>
+    unsigned search(const G &graph, unsigned start) //returns eccentricity of start in its component
+    {
+        begin(graph.size());
+        explore(graph, start, std::numeric_limits<unsigned>::max());
+        return dist[queue.back()];
+    }
+    template <class G>
+    void searchTargets(const G &graph, unsigned start, const std::vector<unsigned> &targets)
+        //search which stops once all targets are reached (vertices further than the last target may stay unreached)
+    {
+        begin(graph.size());
+        if(target.size()!=stamp.size()) target.assign(stamp.size(), 0);
+        unsigned targetsN = 0;
+        for(unsigned v : targets)
+        {
+            if(target[v]==run) continue;
+            target[v] = run;
+            targetsN++;
+        }
+        explore(graph, start, targetsN);
+    }
+    bool reached(unsigned vertex) const //checks if vertex was reached by the last search
+    {
+        return stamp[vertex]==run;
+    }
+    unsigned distance(unsigned vertex) const //distance from start of the last search (vertex must be reached)
+    {
+        assert(reached(vertex));
+        return dist[vertex];
+    }
+    const std::vector<unsigned>& visited() const //reached vertices of the last search by increasing distance
+    {
+        return queue;
+    }
+    std::vector<unsigned> route(unsigned to) const //vertices chain [start-->to] of the last search (empty if not reached)
+    {
+        assert(routes);
+        std::vector<unsigned> res;
+        if(!reached(to)) return res;
+        res.resize(dist[to]+1);
+        unsigned curr = to;
+        for(unsigned i=dist[to]; i>0; i--)
+        {
+            res[i] = curr;
+            curr = prev[curr];
+        }
+        res[0] = curr;
+        return res;
+    }
+};
+
+//runs function(workspace, i) for every i in [begin, end) in parallel, every thread takes a workspace from the pool
+//(new ones are default constructed, so after the call the pool has at most one workspace per thread)
+template <class Workspace, class Function>
+void parallelSearches(std::vector<std::unique_ptr<Workspace>> &pool, unsigned begin, unsigned end, const Function &function)
+{
+    std::mutex poolMutex;
+    parallelFor(begin, end, [&](unsigned i)
+    {
+        std::unique_ptr<Workspace> workspace;
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if(pool.empty()) workspace.reset(new Workspace);
+            else
+            {
+                workspace = std::move(pool.back());
+                pool.pop_back();
+            }
+        }
+        function(*workspace, i);
+        std::lock_guard<std::mutex> lock(poolMutex);
+        pool.push_back(std::move(workspace));
+    }, 1);
+}
+
+struct DiameterBounds
+{
+    unsigned lower; //distance of the farthest pair found
+    unsigned upper; //no 2 connected vertices are farther apart
+};
+
+//diameter of every component by iFUB: a central root is chosen by a 4-sweep (its 2 long paths give the first lower
+//bound, 2*eccentricity of the root the first upper one), then vertices are searched from the farthest BFS level
+//of the root down; after level i the rest are at most 2*(i-1) apart, so it stops when bounds meet or maxSearches
+//searches were done (0 gives only the 4-sweep bounds); vertices of a level are searched in parallel
+inline DiameterBounds diameterBounds(const UndirectedArrays &neighbours, unsigned maxSearches)
+{
+    unsigned verticesN = neighbours.size();
+    BfsWorkspace main;
+    std::vector<std::unique_ptr<BfsWorkspace>> pool; //workspaces of threads searching from fringe vertices
+    std::vector<bool> done(verticesN, false);
+    //distances from ends of the 2 long paths of the 4-sweep (only entries of the current component are valid)
+    std::vector<unsigned> fromA1(verticesN), fromB1(verticesN), fromA2(verticesN), fromB2(verticesN);
+    DiameterBounds res{0, 0};
+    for(unsigned start=0; start<verticesN; start++)
+    {
+        if(done[start]) continue;
+        unsigned lower = main.search(neighbours, start);
+        for(unsigned v : main.visited()) done[v] = true;
+        if(lower==0) continue;
+        auto farthest = [&](unsigned from)
+        {
+            lower = std::max(lower, main.search(neighbours, from));
+            return main.visited().back();
+        };
+        auto sweep = [&](unsigned from, std::vector<unsigned> &dist) //farthest vertex, distances are kept
+        {
+            unsigned far = farthest(from);
+            for(unsigned v : main.visited()) dist[v] = main.distance(v);
+            return far;
+        };
+        //vertex in the middle of some shortest a-b path with the smallest value
+        auto middle = [&](const std::vector<unsigned> &fromA, const std::vector<unsigned> &fromB, unsigned length, const auto &value)
+        {
+            const unsigned none = std::numeric_limits<unsigned>::max();
+            unsigned best = none;
+            for(unsigned v : main.visited())
+            {
+                if(fromA[v]==length/2 && fromB[v]==length-length/2 && (best==none || value(v)<value(best))) best = v;
+            }
+            return best;
+        };
+        //4-sweep: start --> a1 --> b1, middle of a1-b1 --> a2 --> b2, middle of a2-b2 is the root;
+        //the root is the middle closest to a1 and b1 (walking back along one path may end in a corner of a mesh)
+        unsigned a1 = main.visited().back();
+        unsigned b1 = sweep(a1, fromA1);
+        sweep(b1, fromB1);
+        unsigned a2 = farthest(middle(fromA1, fromB1, fromA1[b1], [](unsigned){ return 0u; }));
+        unsigned b2 = sweep(a2, fromA2);
+        sweep(b2, fromB2);
+        unsigned root = middle(fromA2, fromB2, fromA2[b2], [&](unsigned v){ return std::max(fromA1[v], fromB1[v]); });
+        unsigned height = main.search(neighbours, root);
+        lower = std::max(lower, height);
+        //fringes: vertices of the component by distance from the root
+        std::vector<unsigned> byDistance(main.visited());
+        std::vector<unsigned> levelStart(height+2, 0);
+        for(unsigned v : byDistance) levelStart[main.distance(v)+1]++;
+        for(unsigned i=0; i<=height; i++) levelStart[i+1] += levelStart[i];
+        std::vector<unsigned> eccentricity(byDistance.size());
+        unsigned upper = 2*height;
+        for(unsigned level=height; level>0 && lower<upper && maxSearches>0; level--)
+        {
+            unsigned first = levelStart[level], last = first+std::min(levelStart[level+1]-first, maxSearches);
+            maxSearches -= last-first;
+            parallelSearches(pool, first, last, [&](BfsWorkspace &workspace, unsigned i)
+            {
+                eccentricity[i] = workspace.search(neighbours, byDistance[i]);
+            });
+            for(unsigned i=first; i<last; i++) lower = std::max(lower, eccentricity[i]);
+            if(last!=levelStart[level+1]) break; //level is not finished, upper bound stays
+            upper = std::max(lower, 2*(level-1));
+        }
+        res.lower = std::max(res.lower, lower);
+        res.upper = std::max(res.upper, std::max(lower, upper));
+    }
+    return res;
+}
+
+template <class G>
+DiameterBounds diameterBounds(const G &graph, unsigned maxSearches = std::numeric_limits<unsigned>::max())
+{
+    return diameterBounds(undirectedArrays(graph), maxSearches);
+}
+
+template <class G>
+unsigned diameter(const G &graph) //returns the largest distance between 2 connected vertices
+{
+    DiameterBounds bounds = diameterBounds(graph);
+    assert(bounds.lower==bounds.upper);
+    return bounds.lower;
+}
+
+//sampled eccentricities: BFS from samples random sources in parallel, every vertex gets the largest distance
+//to a source, which is a lower bound of its eccentricity (exact for sources, close for peripheral vertices)
+template <class G, class Engine>
+std::vector<unsigned> estimateEccentricities(const G &graph, unsigned samples, Engine &engine)
+{
+    UndirectedArrays neighbours = undirectedArrays(graph);
+    unsigned verticesN = neighbours.size();
+    std::vector<unsigned> res(verticesN, 0);
+    if(verticesN==0) return res;
+    std::vector<unsigned> sources(verticesN);
+    for(unsigned v=0; v<verticesN; v++) sources[v] = v;
+    std::shuffle(sources.begin(), sources.end(), engine);
+    sources.resize(std::min(samples, verticesN));
+    std::vector<std::atomic<unsigned>> bound(verticesN);
+    for(auto &i : bound) i.store(0, std::memory_order_relaxed);
+    std::vector<std::unique_ptr<BfsWorkspace>> pool;
+    parallelSearches(pool, 0, sources.size(), [&](BfsWorkspace &workspace, unsigned i)
+    {
+        auto raise = [&bound](unsigned v, unsigned d)
+        {
+            unsigned current = bound[v].load(std::memory_order_relaxed);
+            while(current<d && !bound[v].compare_exchange_weak(current, d)) {}
+        };
+        raise(sources[i], workspace.search(neighbours, sources[i]));
+        for(unsigned v : workspace.visited()) raise(v, workspace.distance(v));
+    });
+    for(unsigned v=0; v<verticesN; v++) res[v] = bound[v].load(std::memory_order_relaxed);
+    return res;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// betweenness centrality
+
+struct BrandesWorkspace //buffers of one thread: BFS, path counts, dependencies and its share of the result
+{
+    BfsWorkspace bfs;
+    std::vector<double> paths; //number of shortest paths from the source
+    std::vector<double> dependency;
+    std::vector<double> centrality;
+};
+
+//Brandes: BFS from source counts shortest paths, then dependencies are accumulated in reversed BFS order;
+//predecessors are not stored, edges v-->w with dist[w]==dist[v]+1 are found again from the rows
+template <class G>
+void accumulateBetweenness(const G &graph, unsigned source, BrandesWorkspace &workspace)
+{
+    unsigned verticesN = graph.size();
+    if(workspace.centrality.size()!=verticesN)
+    {
+        workspace.paths.assign(verticesN, 0);
+        workspace.dependency.assign(verticesN, 0);
+        workspace.centrality.assign(verticesN, 0);
+    }
+    BfsWorkspace &bfs = workspace.bfs;
+    double *paths = workspace.paths.data(), *dependency = workspace.dependency.data();
+    bfs.search(graph, source);
+    const std::vector<unsigned> &order = bfs.visited();
+    for(unsigned v : order)
+    {
+        paths[v] = 0;
+        dependency[v] = 0;
+    }
+    paths[source] = 1;
+    for(unsigned v : order)
+    {
+        unsigned next = bfs.distance(v)+1;
+        graph.forEachOut(v, [&](unsigned w){ if(bfs.distance(w)==next) paths[w] += paths[v]; });
+    }
+    for(unsigned i=order.size(); i-->1;)
+    {
+        unsigned v = order[i], next = bfs.distance(v)+1;
+        double sum = 0;
+        graph.forEachOut(v, [&](unsigned w){ if(bfs.distance(w)==next) sum += (1+dependency[w])/paths[w]; });
+        dependency[v] = paths[v]*sum;
+        workspace.centrality[v] += dependency[v];
+    }
+}
+
+template <class G>
+std::vector<double> betweennessFromSources(const G &graph, const std::vector<unsigned> &sources, double scale)
+{
+    std::vector<std::unique_ptr<BrandesWorkspace>> pool;
+    parallelSearches(pool, 0, sources.size(), [&](BrandesWorkspace &workspace, unsigned i)
+    {
+        accumulateBetweenness(graph, sources[i], workspace);
+    });
+    std::vector<double> res(graph.size(), 0);
+    for(auto &i : pool)
+    {
+        for(unsigned v=0; v<i->centrality.size(); v++) res[v] += i->centrality[v];
+    }
+    for(auto &i : res) i *= scale;
+    return res;
+}
+
+//returns number of shortest paths between ordered pairs of other vertices going through every vertex
+//(paths are directed, a pair with k shortest paths adds 1/k for each of them); sources are searched in parallel
+template <class G>
+std::vector<double> betweenness(const G &graph)
+{
+    std::vector<unsigned> sources(graph.size());
+    for(unsigned v=0; v<graph.size(); v++) sources[v] = v;
+    return betweennessFromSources(graph, sources, 1);
+}
+
+//estimate of betweenness for large graphs: only samples random sources are searched, sums are scaled by verticesN/samples
+template <class G, class Engine>
+std::vector<double> sampledBetweenness(const G &graph, unsigned samples, Engine &engine)
+{
+    unsigned verticesN = graph.size();
+    assert(samples>0);
+    if(samples>=verticesN) return betweenness(graph);
+    std::vector<unsigned> sources(verticesN);
+    for(unsigned v=0; v<verticesN; v++) sources[v] = v;
+    std::shuffle(sources.begin(), sources.end(), engine);
+    sources.resize(samples);
+    return betweennessFromSources(graph, sources, (double)verticesN/samples);
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// maximum flow and minimum cut
+
+template <class C>
+struct FlowResult
+{
+    C value; //maximum flow from source to sink
+    std::vector<bool> sourceSide; //minimum cut: vertices which can not reach sink in the residual network
+};
+
+//push-relabel (highest label first) over flat residual arrays; global relabel (BFS to sink) runs after every
+//verticesN relabels, gap heuristic lifts vertices above an emptied height out of the way; only the preflow phase is needed,
+//because the flow value and the cut are known when no vertex below height verticesN has excess
+//capacity(data) gives capacity of an edge (a number, negative values are not allowed)
+template <class G, class Capacity>
+auto maxFlow(const G &graph, unsigned source, unsigned sink, const Capacity &capacity)
+    -> FlowResult<typename std::decay<decltype(capacity(graph(0u, 0u)))>::type>
+{
+    typedef typename std::decay<decltype(capacity(graph(0u, 0u)))>::type C;
+    unsigned verticesN = graph.size();
+    assert(source<verticesN && sink<verticesN && source!=sink);
+
+    //residual arcs of vertex v are [offsets[v], offsets[v+1]), arc a goes to arcTo[a], its reverse is mate[a]
+    std::vector<unsigned> offsets(verticesN+1, 0);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        graph.forEachOut(v, [&](unsigned u)
+        {
+            if(u==v) return;
+            offsets[v+1]++;
+            offsets[u+1]++;
+        });
+    }
+    for(unsigned v=0; v<verticesN; v++) offsets[v+1] += offsets[v];
+    std::vector<unsigned> arcTo(offsets[verticesN]), mate(offsets[verticesN]);
+    std::vector<C> residual(offsets[verticesN]);
+    std::vector<unsigned> pos(offsets.begin(), offsets.end()-1);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        graph.forEachOutEdge(v, [&](unsigned u, const auto &data)
+        {
+            if(u==v) return;
+            unsigned forward = pos[v]++, backward = pos[u]++;
+            arcTo[forward] = u;
+            arcTo[backward] = v;
+            mate[forward] = backward;
+            mate[backward] = forward;
+            residual[forward] = capacity(data);
+            residual[backward] = 0;
+            assert(residual[forward]>=0);
+        });
+    }
+
+    std::vector<unsigned> height(verticesN, 0), count(verticesN+1, 0), current(offsets.begin(), offsets.end()-1);
+    std::vector<C> excess(verticesN, 0);
+    std::vector<std::vector<unsigned>> active(verticesN); //vertices with excess by height (below verticesN)
+    std::vector<bool> queued(verticesN, false);
+    unsigned highest = 0; //no active vertex is above it
+    auto activate = [&](unsigned v)
+    {
+        if(!queued[v] && v!=source && v!=sink && height[v]<verticesN && excess[v]>0)
+        {
+            queued[v] = true;
+            active[height[v]].push_back(v);
+            highest = std::max(highest, height[v]);
+        }
+    };
+    auto globalRelabel = [&]()
+    {
+        std::fill(height.begin(), height.end(), verticesN);
+        std::fill(count.begin(), count.end(), 0);
+        height[sink] = 0;
+        std::vector<unsigned> order{sink};
+        for(unsigned i=0; i<order.size(); i++)
+        {
+            unsigned w = order[i];
+            for(unsigned a=offsets[w]; a<offsets[w+1]; a++)
+            {
+                unsigned x = arcTo[a];
+                if(height[x]==verticesN && x!=source && residual[mate[a]]>0)
+                {
+                    height[x] = height[w]+1;
+                    order.push_back(x);
+                }
+            }
+        }
+        for(unsigned v=0; v<verticesN; v++)
+        {
+            if(height[v]<verticesN) count[height[v]]++;
+            current[v] = offsets[v];
+        }
+        //vertices which can not reach sink keep their excess, it does not change the flow value
+        for(auto &i : active) i.clear();
+        highest = 0;
+        std::fill(queued.begin(), queued.end(), false);
+        for(unsigned v=0; v<verticesN; v++) activate(v);
+    };
+
+    for(unsigned a=offsets[source]; a<offsets[source+1]; a++)
+    {
+        C delta = residual[a];
+        residual[a] = 0;
+        residual[mate[a]] += delta;
+        excess[arcTo[a]] += delta;
+    }
+    globalRelabel();
+    unsigned relabels = 0;
+    while(true)
+    {
+        while(highest>0 && active[highest].empty()) highest--;
+        if(active[highest].empty()) break;
+        unsigned v = active[highest].back();
+        active[highest].pop_back();
+        queued[v] = false;
+        if(height[v]>=verticesN) continue; //lifted by a gap
+        //discharge: push along admissible arcs, relabel when they are over
+        while(excess[v]>0)
+        {
+            if(current[v]==offsets[v+1])
+            {
+                unsigned old = height[v], lowest = 2*verticesN;
+                for(unsigned a=offsets[v]; a<offsets[v+1]; a++)
+                {
+                    if(residual[a]>0) lowest = std::min(lowest, height[arcTo[a]]);
+                }
+                count[old]--;
+                height[v] = std::min(lowest+1, verticesN);
+                current[v] = offsets[v];
+                relabels++;
+                if(count[old]==0) //gap: vertices above old can not reach sink any more
+                {
+                    height[v] = verticesN;
+                    for(unsigned u=0; u<verticesN; u++)
+                    {
+                        if(height[u]>old && height[u]<verticesN)
+                        {
+                            count[height[u]]--;
+                            height[u] = verticesN;
+                        }
+                    }
+                }
+                if(height[v]>=verticesN) break;
+                count[height[v]]++;
+                continue;
+            }
+            unsigned a = current[v], w = arcTo[a];
+            if(residual[a]>0 && height[v]==height[w]+1)
+            {
+                C delta = std::min(excess[v], residual[a]);
+                residual[a] -= delta;
+                residual[mate[a]] += delta;
+                excess[v] -= delta;
+                excess[w] += delta;
+                activate(w);
+            }
+            else current[v]++;
+        }
+        if(relabels>=verticesN)
+        {
+            relabels = 0;
+            globalRelabel();
+        }
+    }
+
+    FlowResult<C> res;
+    res.value = excess[sink];
+    //sink side: vertices which reach sink by residual arcs (searched backwards from sink)
+    res.sourceSide.assign(verticesN, true);
+    res.sourceSide[sink] = false;
+    std::vector<unsigned> order{sink};
+    for(unsigned i=0; i<order.size(); i++)
+    {
+        unsigned w = order[i];
+        for(unsigned a=offsets[w]; a<offsets[w+1]; a++)
+        {
+            unsigned x = arcTo[a];
+            if(res.sourceSide[x] && residual[mate[a]]>0)
+            {
+                res.sourceSide[x] = false;
+                order.push_back(x);
+            }
+        }
+    }
+    return res;
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// coloring (edges are treated as undirected, self-loops are ignored)
+
+enum class ColoringOrder
+{
+    largestFirst, //by decreasing degree (Welsh-Powell)
+    smallestLast //reversed peeling order, uses at most (largest core number + 1) colors
+};
+
+//smallest color of v not used by colored neighbours; forbidden is a bit row of at least degree+1 bits,
+//it is cleared back before return, so it can be reused without O(V) resets
+template <class Colors>
+unsigned firstFreeColor(const UndirectedArrays &neighbours, unsigned v, const Colors &color, BitRow &forbidden)
+{
+    const unsigned none = std::numeric_limits<unsigned>::max();
+    unsigned limit = neighbours.offsets[v+1]-neighbours.offsets[v]; //colors above degree are never needed
+    neighbours.forEachOut(v, [&](unsigned u)
+    {
+        unsigned c = color[u];
+        if(c!=none && c<=limit) setBit(forbidden, c);
+    });
+    unsigned res = 0;
+    for(unsigned w=0; ; w++)
+    {
+        if(~forbidden[w])
+        {
+            res = w<<6|lowestBit(~forbidden[w]);
+            break;
+        }
+    }
+    neighbours.forEachOut(v, [&](unsigned u)
+    {
+        unsigned c = color[u];
+        if(c!=none && c<=limit) resetBit(forbidden, c);
+    });
+    return res;
+}
+
+inline unsigned maxDegree(const UndirectedArrays &neighbours)
+{
+    unsigned res = 0;
+    for(unsigned v=0; v<neighbours.size(); v++) res = std::max(res, neighbours.offsets[v+1]-neighbours.offsets[v]);
+    return res;
+}
+
+//returns color of every vertex (0, 1, ...), neighbours get different colors; vertices are colored one by one
+template <class G>
+std::vector<unsigned> greedyColoring(const G &graph, ColoringOrder order = ColoringOrder::smallestLast)
+{
+    UndirectedArrays neighbours = undirectedArrays(graph);
+    unsigned verticesN = neighbours.size();
+    std::vector<unsigned> sequence;
+    if(order==ColoringOrder::smallestLast)
+    {
+        coreNumbers(neighbours, &sequence);
+        std::reverse(sequence.begin(), sequence.end());
+    }
+    else
+    {
+        for(unsigned v=0; v<verticesN; v++) sequence.push_back(v);
+        std::stable_sort(sequence.begin(), sequence.end(), [&](unsigned a, unsigned b)
+        {
+            return neighbours.offsets[a+1]-neighbours.offsets[a]>neighbours.offsets[b+1]-neighbours.offsets[b];
+        });
+    }
+    std::vector<unsigned> color(verticesN, std::numeric_limits<unsigned>::max());
+    BitRow forbidden(maxDegree(neighbours)/64+1, 0);
+    for(unsigned v : sequence) color[v] = firstFreeColor(neighbours, v, color, forbidden);
+    return color;
+}
+
+//speculative coloring (Gebremedhin-Manne): all uncolored vertices are colored in parallel from the colors
+//their neighbours have at the moment, then conflicting pairs are found and the larger vertex is colored again
+template <class G>
+std::vector<unsigned> parallelColoring(const G &graph)
+{
+    const unsigned none = std::numeric_limits<unsigned>::max();
+    UndirectedArrays neighbours = undirectedArrays(graph);
+    unsigned verticesN = neighbours.size();
+    std::vector<std::atomic<unsigned>> color(verticesN);
+    for(auto &i : color) i.store(none, std::memory_order_relaxed);
+    struct relaxedColors //colors read by firstFreeColor while other threads write them
+    {
+        const std::vector<std::atomic<unsigned>> &color;
+        unsigned operator[](unsigned v) const {return color[v].load(std::memory_order_relaxed);}
+    } colors{color};
+    unsigned words = maxDegree(neighbours)/64+1;
+    std::vector<unsigned> uncolored(verticesN), conflicts(verticesN);
+    for(unsigned v=0; v<verticesN; v++) uncolored[v] = v;
+    while(!uncolored.empty())
+    {
+        parallelFor(0, uncolored.size(), [&](unsigned i)
+        {
+            thread_local BitRow forbidden;
+            if(forbidden.size()<words) forbidden.assign(words, 0);
+            unsigned v = uncolored[i];
+            color[v].store(firstFreeColor(neighbours, v, colors, forbidden), std::memory_order_relaxed);
+        }, 256);
+        std::atomic<unsigned> conflictsN{0};
+        parallelFor(0, uncolored.size(), [&](unsigned i)
+        {
+            unsigned v = uncolored[i], c = colors[v];
+            bool conflict = false;
+            neighbours.forEachOut(v, [&](unsigned u){ if(u<v && colors[u]==c) conflict = true; });
+            if(conflict) conflicts[conflictsN++] = v;
+        }, 256);
+        //losers are uncolored first, so they do not see their own old colors
+        uncolored.assign(conflicts.begin(), conflicts.begin()+conflictsN);
+        for(unsigned v : uncolored) color[v].store(none, std::memory_order_relaxed);
+        std::sort(uncolored.begin(), uncolored.end());
+    }
+    std::vector<unsigned> res(verticesN);
+    for(unsigned v=0; v<verticesN; v++) res[v] = colors[v];
+    return res;
+}
+
+#endif
\ No newline at end of file
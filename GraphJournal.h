@@ -0,0 +1,444 @@
+#ifndef GRAPH_JOURNAL_H
+#define GRAPH_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include "Graph.h"
+
+//binary encoding of payloads in journal files
+//trivially copyable types are written as raw bytes, vectors as size + elements,
+//other types need a specialization with the same two functions
+template <class T, class Enable = void>
+struct JournalCodec;
+
+inline void journalWriteNumber(std::string &out, unsigned long long value) //varint (7 bits per byte)
+{
+    while(value>=0x80)
+    {
+        out.push_back((char)((value&0x7f)|0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+inline bool journalReadNumber(const char *&pos, const char *end, unsigned long long &value) //false if input ended
+{
+    value = 0;
+    for(unsigned shift=0; pos<end && shift<64; shift+=7)
+    {
+        unsigned char byte = *pos++;
+        value |= (unsigned long long)(byte&0x7f)<<shift;
+        if(!(byte&0x80)) return true;
+    }
+    return false;
+}
+
+template <class T>
+struct JournalCodec<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+{
+    static void write(std::string &out, const T &value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    static bool read(const char *&pos, const char *end, T &value)
+    {
+        if(end-pos<(long)sizeof(T)) return false;
+        std::memcpy(&value, pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+};
+
+template <class T>
+struct JournalCodec<std::vector<T>>
+{
+    static void write(std::string &out, const std::vector<T> &value)
+    {
+        journalWriteNumber(out, value.size());
+        for(auto &i : value) JournalCodec<T>::write(out, i);
+    }
+    static bool read(const char *&pos, const char *end, std::vector<T> &value)
+    {
+        unsigned long long size;
+        if(!journalReadNumber(pos, end, size) || size>(unsigned long long)(end-pos)) return false;
+        value.resize(size);
+        for(auto &&i : value)
+        {
+            T element;
+            if(!JournalCodec<T>::read(pos, end, element)) return false;
+            i = element;
+        }
+        return true;
+    }
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+
+//write-ahead log of changes of a ListGraph with periodic snapshots
+//files: path.snapshot (whole graph) and path.log (changes made after that snapshot)
+//every change is written to the log before it is applied, recover() loads the snapshot and replays the log tail
+//records are buffered by the stream: flush() pushes them to the OS (no fsync)
+template <class T_vertices, class T_edges>
+class GraphJournal
+{
+private:
+    enum Operation : unsigned char
+    {
+        addVertexOp = 1,
+        delVertexOp,
+        addEdgeOp,
+        delEdgeOp,
+        setVertexOp,
+        setEdgeOp
+    };
+    static const unsigned magicSize = 8;
+
+    ListGraph<T_vertices, T_edges> &graph;
+    std::string logPath;
+    std::string snapshotPath;
+    std::ofstream log;
+    std::string record; //encoded record being written
+    unsigned long long generation; //number of the snapshot the log continues
+    unsigned long long records; //records in the log
+    unsigned long long snapshotEvery; //automatic snapshot after this many records (0 - never)
+
+    bool append(); //writes record to the log, takes automatic snapshot if it is time
+    bool startLog(); //empty log for current generation
+    bool loadSnapshot(const std::string &bytes); //replaces graph with the snapshot
+    unsigned long long replay(const std::string &bytes); //applies log records, returns length of the valid prefix
+    static bool readFile(const std::string &path, std::string &bytes);
+    static void writeHeader(std::string &out, const char *magic, unsigned long long generation);
+    static bool readHeader(const char *&pos, const char *end, const char *magic, unsigned long long &generation);
+public:
+    GraphJournal(ListGraph<T_vertices, T_edges> &graph, const std::string &path, unsigned long long snapshotEvery = 0);
+    GraphJournal(const GraphJournal<T_vertices, T_edges> &toCopy) = delete;
+    GraphJournal<T_vertices, T_edges>& operator=(const GraphJournal<T_vertices, T_edges> &toCopy) = delete;
+    ~GraphJournal(); //flushes the log
+    bool recover(); //restores graph from files (empty graph if there are none) and opens the log, call it first
+    bool addVertex(const T_vertices &data); //logs and adds a new vertex
+    bool delVertex(unsigned vertex); //logs and deletes a vertex
+    bool addEdge(unsigned from, unsigned to, const T_edges &data); //logs and adds a new edge
+    bool delEdge(unsigned from, unsigned to); //logs and deletes an edge
+    bool setVertex(unsigned vertex, const T_vertices &data); //logs and replaces data in vertex
+    bool setEdge(unsigned from, unsigned to, const T_edges &data); //logs and replaces data in edge
+    bool snapshot(); //writes the whole graph and starts an empty log
+    bool flush(); //pushes buffered records to the file
+    unsigned long long logRecords() const; //returns the number of records replay would apply now
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class GraphJournal
+
+template <class T_vertices, class T_edges>
+GraphJournal<T_vertices, T_edges>::GraphJournal(ListGraph<T_vertices, T_edges> &graph, const std::string &path,
+                                                unsigned long long snapshotEvery)
+    : graph(graph), logPath(path+".log"), snapshotPath(path+".snapshot")
+{
+    generation = 0;
+    records = 0;
+    this->snapshotEvery = snapshotEvery;
+}
+
+template <class T_vertices, class T_edges>
+GraphJournal<T_vertices, T_edges>::~GraphJournal()
+{
+    if(log.is_open()) log.flush();
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::readFile(const std::string &path, std::string &bytes)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file) return false;
+    file.seekg(0, std::ios::end);
+    bytes.resize(file.tellg());
+    file.seekg(0, std::ios::beg);
+    file.read(&bytes[0], bytes.size());
+    return (bool)file;
+}
+
+template <class T_vertices, class T_edges>
+void GraphJournal<T_vertices, T_edges>::writeHeader(std::string &out, const char *magic, unsigned long long generation)
+{
+    out.append(magic, magicSize);
+    JournalCodec<unsigned long long>::write(out, generation);
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::readHeader(const char *&pos, const char *end, const char *magic, unsigned long long &generation)
+{
+    if(end-pos<(long)magicSize || std::memcmp(pos, magic, magicSize)!=0) return false;
+    pos += magicSize;
+    return JournalCodec<unsigned long long>::read(pos, end, generation);
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::loadSnapshot(const std::string &bytes)
+{
+    const char *pos = bytes.data(), *end = bytes.data()+bytes.size();
+    unsigned long long snapshotGeneration, verticesN, degree, to;
+    if(!readHeader(pos, end, "GRAPHSNP", snapshotGeneration)) return false;
+    //every vertex takes at least one byte (its degree), so a larger count is corrupt
+    if(!journalReadNumber(pos, end, verticesN) || verticesN>(unsigned long long)(end-pos)) return false;
+    //rows are filled directly, without per-edge checks
+    graph.clear();
+    graph.vertices.reserve(verticesN);
+    graph.edges.reserve(verticesN);
+    T_vertices vertexData;
+    T_edges edgeData;
+    for(unsigned long long i=0; i<verticesN; i++)
+    {
+        if(!JournalCodec<T_vertices>::read(pos, end, vertexData)) return false;
+        graph.addVertex(vertexData);
+    }
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        if(!journalReadNumber(pos, end, degree) || degree>verticesN || degree>(unsigned long long)(end-pos)) return false;
+        graph.edges[i].reserve(degree);
+        for(unsigned long long j=0; j<degree; j++)
+        {
+            if(!journalReadNumber(pos, end, to) || to>=verticesN) return false;
+            if(!JournalCodec<T_edges>::read(pos, end, edgeData)) return false;
+            graph.appendEdge(i, to, edgeData);
+        }
+    }
+    graph.version++;
+    generation = snapshotGeneration;
+    return pos==end;
+}
+
+template <class T_vertices, class T_edges>
+unsigned long long GraphJournal<T_vertices, T_edges>::replay(const std::string &bytes)
+{
+    const char *begin = bytes.data(), *pos = begin, *end = begin+bytes.size();
+    unsigned long long logGeneration, vertex, from, to;
+    if(!readHeader(pos, end, "GRAPHLOG", logGeneration) || logGeneration!=generation) return 0;
+    unsigned long long valid = pos-begin;
+    T_vertices vertexData;
+    T_edges edgeData;
+    //the whole log is decoded from memory, a torn last record or a record which doesn't match the graph ends the replay
+    while(pos<end)
+    {
+        unsigned char operation = *pos++;
+        unsigned n = graph.size();
+        bool ok = false;
+        switch(operation)
+        {
+        case addVertexOp:
+            ok = JournalCodec<T_vertices>::read(pos, end, vertexData);
+            if(ok) graph.addVertex(vertexData);
+            break;
+        case delVertexOp:
+            ok = journalReadNumber(pos, end, vertex) && vertex<n;
+            if(ok) graph.delVertex(vertex);
+            break;
+        case addEdgeOp:
+            ok = journalReadNumber(pos, end, from) && journalReadNumber(pos, end, to) && from<n && to<n &&
+                 JournalCodec<T_edges>::read(pos, end, edgeData);
+            ok = ok && !graph.isEdgeExists(from, to);
+            if(ok)
+            {
+                graph.appendEdge(from, to, edgeData); //rows grow directly, the check above replaces the one of addEdge
+                graph.version++;
+            }
+            break;
+        case delEdgeOp:
+            ok = journalReadNumber(pos, end, from) && journalReadNumber(pos, end, to) && from<n && to<n;
+            ok = ok && graph.isEdgeExists(from, to);
+            if(ok) graph.delEdge(from, to);
+            break;
+        case setVertexOp:
+            ok = journalReadNumber(pos, end, vertex) && vertex<n && JournalCodec<T_vertices>::read(pos, end, vertexData);
+            if(ok) graph(vertex) = vertexData;
+            break;
+        case setEdgeOp:
+            ok = journalReadNumber(pos, end, from) && journalReadNumber(pos, end, to) && from<n && to<n &&
+                 JournalCodec<T_edges>::read(pos, end, edgeData);
+            ok = ok && graph.isEdgeExists(from, to);
+            if(ok) graph(from, to) = edgeData;
+            break;
+        }
+        if(!ok) break;
+        valid = pos-begin;
+        records++;
+    }
+    return valid;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::recover()
+{
+    if(log.is_open()) log.close();
+    std::string bytes;
+    graph.clear();
+    generation = 0;
+    records = 0;
+    if(readFile(snapshotPath, bytes) && !loadSnapshot(bytes)) return false;
+    if(!readFile(logPath, bytes)) return startLog();
+    unsigned long long valid = replay(bytes);
+    if(valid==0) return startLog(); //log of an older snapshot
+    //the log is continued, an invalid tail is cut off: the valid prefix replaces the log by rename (as in snapshot)
+    if(valid!=bytes.size())
+    {
+        std::string tmpPath = logPath+".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary|std::ios::trunc);
+            file.write(bytes.data(), valid);
+            file.close();
+            if(!file) return false;
+        }
+        if(std::rename(tmpPath.c_str(), logPath.c_str())!=0) return false;
+    }
+    log.open(logPath, std::ios::binary|std::ios::app);
+    return (bool)log;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::startLog()
+{
+    if(log.is_open()) log.close();
+    log.open(logPath, std::ios::binary|std::ios::trunc);
+    record.clear();
+    writeHeader(record, "GRAPHLOG", generation);
+    log.write(record.data(), record.size());
+    records = 0;
+    return (bool)log;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::append()
+{
+    if(!log.is_open()) return false;
+    log.write(record.data(), record.size());
+    if(!log) return false;
+    records++;
+    return true;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::addVertex(const T_vertices &data)
+{
+    record.assign(1, (char)addVertexOp);
+    JournalCodec<T_vertices>::write(record, data);
+    if(!append()) return false;
+    graph.addVertex(data);
+    if(snapshotEvery && records>=snapshotEvery) return snapshot();
+    return true;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::delVertex(unsigned vertex)
+{
+    assert(vertex<graph.size());
+    record.assign(1, (char)delVertexOp);
+    journalWriteNumber(record, vertex);
+    if(!append()) return false;
+    graph.delVertex(vertex);
+    if(snapshotEvery && records>=snapshotEvery) return snapshot();
+    return true;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::addEdge(unsigned from, unsigned to, const T_edges &data)
+{
+    assert(from<graph.size() && to<graph.size());
+    assert(!graph.isEdgeExists(from, to));
+    record.assign(1, (char)addEdgeOp);
+    journalWriteNumber(record, from);
+    journalWriteNumber(record, to);
+    JournalCodec<T_edges>::write(record, data);
+    if(!append()) return false;
+    graph.addEdge(from, to, data);
+    if(snapshotEvery && records>=snapshotEvery) return snapshot();
+    return true;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::delEdge(unsigned from, unsigned to)
+{
+    assert(graph.isEdgeExists(from, to));
+    record.assign(1, (char)delEdgeOp);
+    journalWriteNumber(record, from);
+    journalWriteNumber(record, to);
+    if(!append()) return false;
+    graph.delEdge(from, to);
+    if(snapshotEvery && records>=snapshotEvery) return snapshot();
+    return true;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::setVertex(unsigned vertex, const T_vertices &data)
+{
+    assert(vertex<graph.size());
+    record.assign(1, (char)setVertexOp);
+    journalWriteNumber(record, vertex);
+    JournalCodec<T_vertices>::write(record, data);
+    if(!append()) return false;
+    graph(vertex) = data;
+    if(snapshotEvery && records>=snapshotEvery) return snapshot();
+    return true;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::setEdge(unsigned from, unsigned to, const T_edges &data)
+{
+    assert(graph.isEdgeExists(from, to));
+    record.assign(1, (char)setEdgeOp);
+    journalWriteNumber(record, from);
+    journalWriteNumber(record, to);
+    JournalCodec<T_edges>::write(record, data);
+    if(!append()) return false;
+    graph(from, to) = data;
+    if(snapshotEvery && records>=snapshotEvery) return snapshot();
+    return true;
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::snapshot()
+{
+    //new snapshot replaces the old one by rename, the old log doesn't match its generation any more
+    std::string bytes;
+    writeHeader(bytes, "GRAPHSNP", generation+1);
+    unsigned n = graph.size();
+    journalWriteNumber(bytes, n);
+    for(unsigned i=0; i<n; i++) JournalCodec<T_vertices>::write(bytes, graph(i));
+    for(unsigned i=0; i<n; i++)
+    {
+        journalWriteNumber(bytes, graph.outDegree(i));
+        graph.forEachOutEdge(i, [&bytes](unsigned u, const T_edges &data)
+        {
+            journalWriteNumber(bytes, u);
+            JournalCodec<T_edges>::write(bytes, data);
+        });
+    }
+    std::string tmpPath = snapshotPath+".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary|std::ios::trunc);
+        file.write(bytes.data(), bytes.size());
+        file.close();
+        if(!file) return false;
+    }
+    if(std::rename(tmpPath.c_str(), snapshotPath.c_str())!=0) return false;
+    generation++;
+    return startLog();
+}
+
+template <class T_vertices, class T_edges>
+bool GraphJournal<T_vertices, T_edges>::flush()
+{
+    if(!log.is_open()) return false;
+    log.flush();
+    return (bool)log;
+}
+
+template <class T_vertices, class T_edges>
+unsigned long long GraphJournal<T_vertices, T_edges>::logRecords() const
+{
+    return records;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,249 @@
+#ifndef QUERY_EXECUTOR_H
+#define QUERY_EXECUTOR_H
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <cassert>
+#include "GraphAlgorithms.h"
+
+//---------------------------------------------------------------------------------------------------------------//
+
+struct QueryStats
+{
+    unsigned long long completed; //answered queries (counted after their futures are ready)
+    unsigned long long searches; //BFS runs (waiting queries with the same source share one run)
+    unsigned queued; //queries waiting for a worker
+    double p50, p90, p99; //latency from submission to answer in microseconds (over the last answered queries)
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+
+//answers path and reachability queries on a shared graph in a pool of worker threads
+//every worker keeps its own BfsWorkspace (with routes), so a query allocates only its answer
+//queries are grouped by source: a worker takes all waiting queries of one source and answers them by one BFS
+//the graph is only read through forEachOut and must not be changed while the executor exists
+template <class G>
+class QueryExecutor
+{
+private:
+    enum QueryKind
+    {
+        pathQuery,
+        lengthQuery,
+        countQuery
+    };
+    struct query
+    {
+        QueryKind kind;
+        unsigned to;
+        std::chrono::steady_clock::time_point submitted;
+        std::promise<std::vector<unsigned>> route; //answer of pathQuery
+        std::promise<unsigned> number; //answer of lengthQuery and countQuery
+    };
+    static const unsigned latencyWindow = 4096; //number of last latencies kept for percentiles
+
+    const G &graph;
+    std::vector<std::thread> workers;
+    mutable std::mutex lock; //guards the queue and statistics
+    std::condition_variable wake;
+    std::unordered_map<unsigned, std::vector<query>> pending; //waiting queries by source
+    std::deque<unsigned> sources; //sources with waiting queries in order of their first query
+    unsigned queued = 0;
+    bool stopping = false;
+    unsigned long long completed = 0;
+    unsigned long long searches = 0;
+    std::vector<double> latencies; //ring of the last latencies in microseconds
+    unsigned latencyPos = 0; //next slot of the ring
+
+    void submit(unsigned from, query &&added); //queues query of the given source
+    void work(); //loop of one worker thread
+    void answer(BfsWorkspace &workspace, std::vector<unsigned> &targets, unsigned from, std::vector<query> &batch);
+public:
+    explicit QueryExecutor(const G &graph, unsigned threadsN = hardwareThreads());
+    QueryExecutor(const QueryExecutor<G> &toCopy) = delete;
+    QueryExecutor<G>& operator=(const QueryExecutor<G> &toCopy) = delete;
+    ~QueryExecutor(); //answers all submitted queries and stops the workers
+    std::future<std::vector<unsigned>> path(unsigned from, unsigned to); //vertices chain [from-->to] (empty if disconnected), from!=to
+    std::future<unsigned> pathLength(unsigned from, unsigned to); //number of edges between 2 vertices (or 0, if disconnected), from!=to
+    std::future<unsigned> reachedCount(unsigned from); //number of vertices reachable from from (with from itself)
+    unsigned queueDepth() const; //queries waiting for a worker
+    QueryStats stats() const;
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class QueryExecutor
+
+template <class G>
+QueryExecutor<G>::QueryExecutor(const G &graph, unsigned threadsN)
+    : graph(graph)
+{
+    assert(threadsN>0);
+    latencies.reserve(latencyWindow);
+    for(unsigned i=0; i<threadsN; i++) workers.emplace_back([this]{ work(); });
+}
+
+template <class G>
+QueryExecutor<G>::~QueryExecutor()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(auto &i : workers) i.join();
+}
+
+template <class G>
+void QueryExecutor<G>::submit(unsigned from, query &&added)
+{
+    assert(from<graph.size() && added.to<graph.size());
+    added.submitted = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        assert(!stopping);
+        std::vector<query> &batch = pending[from];
+        if(batch.empty()) sources.push_back(from);
+        batch.push_back(std::move(added));
+        queued++;
+    }
+    wake.notify_one();
+}
+
+template <class G>
+void QueryExecutor<G>::work()
+{
+    BfsWorkspace workspace(true);
+    std::vector<unsigned> targets; //destinations of the current batch
+    std::vector<query> batch;
+    while(true)
+    {
+        unsigned from;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [this]{ return stopping || !sources.empty(); });
+            if(sources.empty()) return; //stopping and nothing is left
+            from = sources.front();
+            sources.pop_front();
+            auto found = pending.find(from);
+            batch = std::move(found->second);
+            pending.erase(found);
+            queued -= batch.size();
+        }
+        answer(workspace, targets, from, batch);
+        batch.clear();
+    }
+}
+
+template <class G>
+void QueryExecutor<G>::answer(BfsWorkspace &workspace, std::vector<unsigned> &targets, unsigned from, std::vector<query> &batch)
+{
+    bool everything = false; //a count query needs all reachable vertices
+    targets.clear();
+    for(auto &i : batch)
+    {
+        if(i.kind==countQuery) everything = true;
+        else targets.push_back(i.to);
+    }
+    if(everything) workspace.search(graph, from);
+    else workspace.searchTargets(graph, from, targets);
+    for(auto &i : batch)
+    {
+        if(i.kind==pathQuery)
+        {
+            i.route.set_value(workspace.route(i.to));
+        }
+        else if(i.kind==lengthQuery)
+        {
+            i.number.set_value(workspace.reached(i.to) ? workspace.distance(i.to) : 0);
+        }
+        else i.number.set_value(workspace.visited().size());
+    }
+    //statistics are recorded once the answers are available, so completed never runs ahead of the futures
+    auto finished = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> guard(lock);
+    for(auto &i : batch)
+    {
+        std::chrono::duration<double, std::micro> latency = finished-i.submitted;
+        if(latencies.size()<latencyWindow) latencies.push_back(latency.count());
+        else latencies[latencyPos] = latency.count();
+        latencyPos = (latencyPos+1)%latencyWindow;
+    }
+    completed += batch.size();
+    searches++;
+}
+
+template <class G>
+std::future<std::vector<unsigned>> QueryExecutor<G>::path(unsigned from, unsigned to)
+{
+    assert(from!=to);
+    query added;
+    added.kind = pathQuery;
+    added.to = to;
+    std::future<std::vector<unsigned>> res = added.route.get_future();
+    submit(from, std::move(added));
+    return res;
+}
+
+template <class G>
+std::future<unsigned> QueryExecutor<G>::pathLength(unsigned from, unsigned to)
+{
+    assert(from!=to);
+    query added;
+    added.kind = lengthQuery;
+    added.to = to;
+    std::future<unsigned> res = added.number.get_future();
+    submit(from, std::move(added));
+    return res;
+}
+
+template <class G>
+std::future<unsigned> QueryExecutor<G>::reachedCount(unsigned from)
+{
+    query added;
+    added.kind = countQuery;
+    added.to = from;
+    std::future<unsigned> res = added.number.get_future();
+    submit(from, std::move(added));
+    return res;
+}
+
+template <class G>
+unsigned QueryExecutor<G>::queueDepth() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return queued;
+}
+
+template <class G>
+QueryStats QueryExecutor<G>::stats() const
+{
+    std::vector<double> window;
+    QueryStats res;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        res.completed = completed;
+        res.searches = searches;
+        res.queued = queued;
+        window = latencies;
+    }
+    auto percentile = [&](double fraction)
+    {
+        if(window.empty()) return 0.0;
+        auto nth = window.begin()+(unsigned)(fraction*(window.size()-1));
+        std::nth_element(window.begin(), nth, window.end());
+        return *nth;
+    };
+    res.p50 = percentile(0.5);
+    res.p90 = percentile(0.9);
+    res.p99 = percentile(0.99);
+    return res;
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef VERTEX_STORE_H
+#define VERTEX_STORE_H
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cassert>
+
+template <class A>
+struct VertexAttribute //handle of a typed attribute column in VertexStore
+{
+    unsigned index;
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+
+//vertex payloads kept apart from topology: vertex number --> slot --> payload
+//deletion moves only the last payload into the freed slot, renumbering touches only the slot table
+//attributes are extra typed columns in the same slot order (e.g. weights or labels read by hot loops)
+template <class T_vertices>
+class VertexStore
+{
+private:
+    struct columnBase
+    {
+        virtual ~columnBase() = default;
+        virtual void push() = 0; //append initial value
+        virtual void swapRemove(unsigned slot) = 0; //move last value into slot and shrink
+        virtual void clear() = 0;
+        virtual std::unique_ptr<columnBase> clone() const = 0;
+    };
+    template <class A>
+    struct column : public columnBase
+    {
+        std::vector<A> values; //values in slot order
+        A initial; //value of new vertices
+
+        explicit column(const A &initial) : initial(initial) {}
+        void push() override;
+        void swapRemove(unsigned slot) override;
+        void clear() override;
+        std::unique_ptr<columnBase> clone() const override;
+    };
+
+    std::vector<T_vertices> payloads; //payloads in slot order
+    std::vector<unsigned> slots; //slot of every vertex
+    std::vector<unsigned> owners; //vertex of every slot
+    std::vector<std::unique_ptr<columnBase>> columns; //attribute columns
+
+    template <class A>
+    column<A>& getColumn(VertexAttribute<A> attribute) const;
+public:
+    VertexStore() = default;
+    VertexStore(const VertexStore<T_vertices> &toCopy); //copy constructor (attribute columns are cloned)
+    VertexStore(VertexStore<T_vertices> &&toMove) = default;
+    VertexStore<T_vertices>& operator=(const VertexStore<T_vertices> &toCopy);
+    VertexStore<T_vertices>& operator=(VertexStore<T_vertices> &&toMove) = default;
+    unsigned size() const; //returns the number of vertices
+    void reserve(unsigned verticesN);
+    void push_back(const T_vertices &data); //add payload of a new last vertex
+    void erase(unsigned vertex); //delete vertex, numbers of all next vertices are decremented
+    void permute(const std::vector<unsigned> &order); //vertex i becomes old vertex order[i] (payloads are not moved)
+    void clear(); //delete all vertices (attribute columns stay registered)
+    template <class A>
+    VertexAttribute<A> addAttribute(const A &initial); //add typed column, every vertex gets initial value
+    template <class A>
+    A& attribute(VertexAttribute<A> attribute, unsigned vertex); //get a reference to attribute of vertex
+    template <class A>
+    const A& attribute(VertexAttribute<A> attribute, unsigned vertex) const; //get a const reference to attribute of vertex
+    template <class A>
+    const std::vector<A>& attributeColumn(VertexAttribute<A> attribute) const; //all values in slot order
+    unsigned slot(unsigned vertex) const; //position of vertex in payload and attribute columns
+    T_vertices& operator[](unsigned vertex); //get a reference to payload
+    const T_vertices& operator[](unsigned vertex) const; //get a const reference to payload
+};
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class VertexStore::column
+
+template <class T_vertices>
+template <class A>
+void VertexStore<T_vertices>::column<A>::push()
+{
+    values.push_back(initial);
+}
+
+template <class T_vertices>
+template <class A>
+void VertexStore<T_vertices>::column<A>::swapRemove(unsigned slot)
+{
+    if(slot+1!=values.size()) values[slot] = std::move(values.back());
+    values.pop_back();
+}
+
+template <class T_vertices>
+template <class A>
+void VertexStore<T_vertices>::column<A>::clear()
+{
+    values.clear();
+}
+
+template <class T_vertices>
+template <class A>
+std::unique_ptr<typename VertexStore<T_vertices>::columnBase> VertexStore<T_vertices>::column<A>::clone() const
+{
+    return std::unique_ptr<columnBase>(new column<A>(*this));
+}
+
+//---------------------------------------------------------------------------------------------------------------//
+// functions related to class VertexStore
+
+template <class T_vertices>
+VertexStore<T_vertices>::VertexStore(const VertexStore<T_vertices> &toCopy)
+{
+    *this = toCopy;
+}
+
+template <class T_vertices>
+VertexStore<T_vertices>& VertexStore<T_vertices>::operator=(const VertexStore<T_vertices> &toCopy)
+{
+    if(this==&toCopy) return *this;
+    payloads = toCopy.payloads;
+    slots = toCopy.slots;
+    owners = toCopy.owners;
+    columns.clear();
+    for(auto &i : toCopy.columns) columns.push_back(i->clone());
+    return *this;
+}
+
+template <class T_vertices>
+unsigned VertexStore<T_vertices>::size() const
+{
+    return slots.size();
+}
+
+template <class T_vertices>
+void VertexStore<T_vertices>::reserve(unsigned verticesN)
+{
+    payloads.reserve(verticesN);
+    slots.reserve(verticesN);
+    owners.reserve(verticesN);
+}
+
+template <class T_vertices>
+void VertexStore<T_vertices>::push_back(const T_vertices &data)
+{
+    slots.push_back(payloads.size());
+    owners.push_back(slots.size()-1);
+    payloads.push_back(data);
+    for(auto &i : columns) i->push();
+}
+
+template <class T_vertices>
+void VertexStore<T_vertices>::erase(unsigned vertex)
+{
+    assert(vertex<slots.size());
+    unsigned freed = slots[vertex], last = payloads.size()-1;
+    //the last slot is moved into the freed one, so only one payload is moved
+    if(freed!=last)
+    {
+        payloads[freed] = std::move(payloads[last]);
+        owners[freed] = owners[last];
+        slots[owners[freed]] = freed;
+    }
+    payloads.pop_back();
+    owners.pop_back();
+    for(auto &i : columns) i->swapRemove(freed);
+    //numbers of next vertices are shifted in the slot table only
+    slots.erase(slots.begin()+vertex);
+    for(auto &i : owners)
+    {
+        if(i>vertex) i--;
+    }
+}
+
+template <class T_vertices>
+void VertexStore<T_vertices>::permute(const std::vector<unsigned> &order)
+{
+    assert(order.size()==slots.size());
+    std::vector<unsigned> newSlots(slots.size());
+    for(unsigned i=0; i<slots.size(); i++)
+    {
+        newSlots[i] = slots[order[i]];
+        owners[newSlots[i]] = i;
+    }
+    slots = std::move(newSlots);
+}
+
+template <class T_vertices>
+void VertexStore<T_vertices>::clear()
+{
+    payloads.clear();
+    slots.clear();
+    owners.clear();
+    for(auto &i : columns) i->clear();
+}
+
+template <class T_vertices>
+template <class A>
+typename VertexStore<T_vertices>::template column<A>& VertexStore<T_vertices>::getColumn(VertexAttribute<A> attribute) const
+{
+    assert(attribute.index<columns.size());
+    assert(dynamic_cast<column<A>*>(columns[attribute.index].get())); //handle of other type or other store
+    return static_cast<column<A>&>(*columns[attribute.index]);
+}
+
+template <class T_vertices>
+template <class A>
+VertexAttribute<A> VertexStore<T_vertices>::addAttribute(const A &initial)
+{
+    column<A> *added = new column<A>(initial);
+    added->values.assign(payloads.size(), initial);
+    columns.emplace_back(added);
+    return {(unsigned)columns.size()-1};
+}
+
+template <class T_vertices>
+template <class A>
+A& VertexStore<T_vertices>::attribute(VertexAttribute<A> attribute, unsigned vertex)
+{
+    assert(vertex<slots.size());
+    return getColumn(attribute).values[slots[vertex]];
+}
+
+template <class T_vertices>
+template <class A>
+const A& VertexStore<T_vertices>::attribute(VertexAttribute<A> attribute, unsigned vertex) const
+{
+    assert(vertex<slots.size());
+    return getColumn(attribute).values[slots[vertex]];
+}
+
+template <class T_vertices>
+template <class A>
+const std::vector<A>& VertexStore<T_vertices>::attributeColumn(VertexAttribute<A> attribute) const
+{
+    return getColumn(attribute).values;
+}
+
+template <class T_vertices>
+unsigned VertexStore<T_vertices>::slot(unsigned vertex) const
+{
+    assert(vertex<slots.size());
+    return slots[vertex];
+}
+
+template <class T_vertices>
+T_vertices& VertexStore<T_vertices>::operator[](unsigned vertex)
+{
+    assert(vertex<slots.size());
+    return payloads[slots[vertex]];
+}
+
+template <class T_vertices>
+const T_vertices& VertexStore<T_vertices>::operator[](unsigned vertex) const
+{
+    assert(vertex<slots.size());
+    return payloads[slots[vertex]];
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../Graph.h"
+#include "../GraphJournal.h"
+#include "../QueryExecutor.h"
+
+template <class Function>
+double measure(const Function &function, unsigned repeats = 3) //returns best time in milliseconds
+{
+    double best = std::numeric_limits<double>::max();
+    for(unsigned i=0; i<repeats; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now()-start;
+        best = std::min(best, time.count());
+    }
+    return best;
+}
+
+void printRow(const std::string &name, double first, double second)
+{
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << first << std::setw(12) << second << "\n";
+}
+
+//grid with both directions of edges and randomly shuffled vertex numbers
+ListGraph<int, int> shuffledGrid(unsigned side)
+{
+    unsigned n = side*side;
+    std::vector<unsigned> ids(n);
+    for(unsigned i=0; i<n; i++) ids[i] = i;
+    std::shuffle(ids.begin(), ids.end(), mt);
+    ListGraph<int, int> graph;
+    for(unsigned i=0; i<n; i++) graph.addVertex(0);
+    for(unsigned r=0; r<side; r++)
+    {
+        for(unsigned c=0; c<side; c++)
+        {
+            unsigned v = ids[r*side+c];
+            if(c+1<side) graph.addEdge(v, ids[r*side+c+1], 1);
+            if(c>0) graph.addEdge(v, ids[r*side+c-1], 1);
+            if(r+1<side) graph.addEdge(v, ids[(r+1)*side+c], 1);
+            if(r>0) graph.addEdge(v, ids[(r-1)*side+c], 1);
+        }
+    }
+    return graph;
+}
+
+void benchmarkReorder()
+{
+    unsigned side = 1000;
+    std::cout << "Reorder (shuffled " << side << "x" << side << " grid), ms\n";
+    std::cout << std::left << std::setw(28) << "strategy" << std::right << std::setw(12) << "BFS" << std::setw(12) << "SCC" << "\n";
+    ListGraph<int, int> original = shuffledGrid(side);
+    unsigned last = original.size()-1;
+    printRow("none", measure([&]{ original.getPathVertices(0, last); }),
+             measure([&]{ original.stronglyConnectedComponents(); }));
+    std::vector<std::pair<std::string, ReorderStrategy>> strategies = {
+        {"reverseCuthillMcKee", ReorderStrategy::reverseCuthillMcKee}, {"degree", ReorderStrategy::degree},
+        {"bfs", ReorderStrategy::bfs}, {"gorderLite", ReorderStrategy::gorderLite}};
+    for(auto &i : strategies)
+    {
+        ListGraph<int, int> graph = original;
+        std::vector<unsigned> permutation = graph.reorder(i.second);
+        printRow(i.first, measure([&]{ graph.getPathVertices(permutation[0], permutation[last]); }),
+                 measure([&]{ graph.stronglyConnectedComponents(); }));
+    }
+    std::cout << "\n";
+}
+
+void benchmarkCompressed()
+{
+    unsigned side = 1000;
+    std::cout << "Compressed adjacency (" << side << "x" << side << " grid in BFS order)\n";
+    ListGraph<int, int> graph = shuffledGrid(side);
+    graph.reorder(ReorderStrategy::bfs);
+    CompressedGraph compressed = graph.compress();
+    unsigned last = graph.size()-1;
+    std::cout << "bytes per edge (with offsets): " << std::fixed << std::setprecision(2)
+              << (double)compressed.memoryBytes()/compressed.edgesCount() << "\n";
+    std::cout << std::left << std::setw(28) << "storage" << std::right << std::setw(12) << "BFS" << std::setw(12) << "SCC" << "\n";
+    printRow("ListGraph", measure([&]{ graph.getPathVertices(0, last); }),
+             measure([&]{ graph.stronglyConnectedComponents(); }));
+    printRow("CompressedGraph", measure([&]{ compressed.getPathVertices(0, last); }),
+             measure([&]{ compressed.stronglyConnectedComponents(); }));
+    std::cout << "\n";
+}
+
+void benchmarkJournal()
+{
+    unsigned side = 500;
+    std::string path = "graph_journal_benchmark";
+    std::cout << "Journal recovery (" << side << "x" << side << " grid)\n";
+    std::cout << std::left << std::setw(28) << "source" << std::right << std::setw(12) << "ms" << std::setw(12) << "MB" << "\n";
+    ListGraph<int, int> original = shuffledGrid(side);
+    ListGraph<int, int> graph;
+    auto fileMB = [](const std::string &name)
+    {
+        std::ifstream file(name, std::ios::binary|std::ios::ate);
+        return file.tellg()/1e6;
+    };
+    {
+        std::remove((path+".snapshot").c_str());
+        GraphJournal<int, int> journal(graph, path);
+        journal.recover();
+        for(unsigned i=0; i<original.size(); i++) journal.addVertex(original(i));
+        for(auto &i : original.getEdges()) journal.addEdge(i[0], i[1], original(i[0], i[1]));
+    }
+    printRow("log replay", measure([&]{ GraphJournal<int, int>(graph, path).recover(); }), fileMB(path+".log"));
+    {
+        GraphJournal<int, int> journal(graph, path);
+        journal.recover();
+        journal.snapshot();
+    }
+    printRow("snapshot load", measure([&]{ GraphJournal<int, int>(graph, path).recover(); }), fileMB(path+".snapshot"));
+    std::remove((path+".log").c_str());
+    std::remove((path+".snapshot").c_str());
+    std::cout << "\n";
+}
+
+void benchmarkPageRank()
+{
+    unsigned verticesN = 1000000, degree = 8;
+    std::cout << "PageRank (" << verticesN << " vertices, " << degree << " random out-edges each, 20 iterations), ms\n";
+    std::cout << std::left << std::setw(28) << "kernel" << std::right << std::setw(12) << "total" << std::setw(12) << "setup" << "\n";
+    ListGraph<int, int> graph;
+    std::uniform_int_distribution<unsigned> randVertex(0, verticesN-1);
+    for(unsigned i=0; i<verticesN; i++) graph.addVertex(0);
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        while(graph.outDegree(i)<degree)
+        {
+            unsigned to = randVertex(mt);
+            if(!graph.isEdgeExists(i, to)) graph.addEdge(i, to, 1);
+        }
+    }
+    PageRankOptions options;
+    options.tolerance = 0;
+    options.maxIterations = 20;
+    //naive push: every vertex scatters its rank to the rows of neighbours in the list graph
+    printRow("push (ListGraph rows)", measure([&]
+    {
+        std::vector<double> rank(verticesN, 1.0/verticesN), next(verticesN);
+        for(unsigned i=0; i<options.maxIterations; i++)
+        {
+            std::fill(next.begin(), next.end(), 0);
+            double lost = 0;
+            for(unsigned v=0; v<verticesN; v++)
+            {
+                unsigned outDegree = graph.outDegree(v);
+                if(outDegree==0) lost += rank[v];
+                graph.forEachOut(v, [&](unsigned u){ next[u] += rank[v]/outDegree; });
+            }
+            for(unsigned v=0; v<verticesN; v++) next[v] = (1-options.damping)/verticesN+options.damping*(next[v]+lost/verticesN);
+            rank.swap(next);
+        }
+    }), 0);
+    //setup of pull kernel is building of in-edge arrays (included in total)
+    printRow("pull (in-edge arrays)", measure([&]{ pageRank(graph, options); }), measure([&]{ transposed(graph); }));
+    std::cout << "\n";
+}
+
+void benchmarkDiameter()
+{
+    std::cout << "Diameter bounds (edges as undirected)\n";
+    std::cout << std::left << std::setw(28) << "graph, searches" << std::right << std::setw(12) << "ms" << std::setw(12) << "upper-lower" << "\n";
+    UndirectedArrays grid = undirectedArrays(shuffledGrid(1000));
+    DiameterBounds bounds;
+    double time = measure([&]{ bounds = diameterBounds(grid); }, 1);
+    printRow("1000x1000 grid, exact", time, bounds.upper-bounds.lower);
+    AdjacencyArrays random;
+    unsigned verticesN = 1000000;
+    std::uniform_int_distribution<unsigned> randVertex(0, verticesN-1);
+    for(unsigned v=0; v<verticesN; v++)
+    {
+        for(unsigned i=0; i<3; i++) random.targets.push_back(randVertex(mt));
+        random.offsets.push_back(random.targets.size());
+    }
+    UndirectedArrays neighbours = undirectedArrays(random);
+    for(unsigned searches : {0u, 16u})
+    {
+        time = measure([&]{ bounds = diameterBounds(neighbours, searches); }, 1);
+        printRow("1M random, " + std::to_string(searches), time, bounds.upper-bounds.lower);
+    }
+    std::cout << "\n";
+}
+
+void benchmarkMaxFlow()
+{
+    std::cout << "Max flow (push-relabel, random capacities 1..100)\n";
+    std::cout << std::left << std::setw(28) << "graph" << std::right << std::setw(12) << "ms" << std::setw(12) << "flow" << "\n";
+    std::uniform_int_distribution<int> randCapacity(1, 100);
+    auto capacity = [](int data){ return (long long)data; };
+    //grid with edges right, up and down, flow from the left column to the right one through 2 extra vertices
+    unsigned side = 500;
+    ListGraph<int, int> grid;
+    for(unsigned i=0; i<side*side+2; i++) grid.addVertex(0);
+    unsigned source = side*side, sink = side*side+1;
+    for(unsigned r=0; r<side; r++)
+    {
+        grid.addEdge(source, r*side, 1000);
+        grid.addEdge(r*side+side-1, sink, 1000);
+        for(unsigned c=0; c<side; c++)
+        {
+            unsigned v = r*side+c;
+            if(c+1<side) grid.addEdge(v, v+1, randCapacity(mt));
+            if(r+1<side) grid.addEdge(v, v+side, randCapacity(mt));
+            if(r>0) grid.addEdge(v, v-side, randCapacity(mt));
+        }
+    }
+    FlowResult<long long> flow;
+    double time = measure([&]{ flow = maxFlow(grid, source, sink, capacity); }, 1);
+    printRow(std::to_string(side) + "x" + std::to_string(side) + " grid", time, flow.value);
+    unsigned verticesN = 200000;
+    ListGraph<int, int> random;
+    std::uniform_int_distribution<unsigned> randVertex(0, verticesN-1);
+    for(unsigned i=0; i<verticesN; i++) random.addVertex(0);
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        while(random.outDegree(i)<5)
+        {
+            unsigned to = randVertex(mt);
+            if(to!=i && !random.isEdgeExists(i, to)) random.addEdge(i, to, randCapacity(mt));
+        }
+    }
+    time = measure([&]{ flow = maxFlow(random, 0, 1, capacity); }, 1);
+    printRow("200k random, 5 out-edges", time, flow.value);
+    std::cout << "\n";
+}
+
+void benchmarkQueryExecutor()
+{
+    std::cout << "Path queries (200k random, 5 out-edges, 2000 queries from 20 sources)\n";
+    std::cout << std::left << std::setw(28) << "way" << std::right << std::setw(12) << "ms" << std::setw(12) << "p99 us" << "\n";
+    unsigned verticesN = 200000;
+    ListGraph<int, int> graph;
+    std::uniform_int_distribution<unsigned> randVertex(0, verticesN-1);
+    for(unsigned i=0; i<verticesN; i++) graph.addVertex(0);
+    for(unsigned i=0; i<verticesN; i++)
+    {
+        while(graph.outDegree(i)<5)
+        {
+            unsigned to = randVertex(mt);
+            if(to!=i && !graph.isEdgeExists(i, to)) graph.addEdge(i, to, 0);
+        }
+    }
+    std::vector<std::pair<unsigned, unsigned>> queries;
+    for(unsigned i=0; i<2000; i++) queries.emplace_back(i%20, randVertex(mt));
+    unsigned long long total = 0;
+    double time = measure([&]
+    {
+        for(auto &i : queries) total += pathVertices(graph, i.first, i.second).size();
+    }, 1);
+    printRow("pathVertices one by one", time, 0);
+    QueryStats stats;
+    time = measure([&]
+    {
+        QueryExecutor<ListGraph<int, int>> executor(graph);
+        std::vector<std::future<std::vector<unsigned>>> routes;
+        for(auto &i : queries) routes.push_back(executor.path(i.first, i.second));
+        for(auto &i : routes) total += i.get().size();
+        stats = executor.stats();
+    }, 1);
+    printRow("executor, " + std::to_string(stats.searches) + " searches", time, stats.p99);
+    std::cout << "\n";
+}
+
+int main()
+{
+    benchmarkReorder();
+    benchmarkCompressed();
+    benchmarkJournal();
+    benchmarkPageRank();
+    benchmarkDiameter();
+    benchmarkMaxFlow();
+    benchmarkQueryExecutor();
+    return 0;
+}
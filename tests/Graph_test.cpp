@@ -1,5 +1,7 @@
 #include <vector>
 #include "../Graph.h"
+#include "../GraphJournal.h"
+#include "../QueryExecutor.h"
 #include "gtest/gtest.h"
 
 TEST(Graph, TestRandomGraph)
@@ -54,4 +56,1535 @@ TEST(Graph, TestRandomGraph)
         matrixGraph.clear();
         listGraph.clear();
     }
-}
\ No newline at end of file
+}
+TEST(Graph, TestStronglyConnectedComponents)
+{
+    unsigned iter = 500;
+
+    MatrixGraph<double, double> matrixGraph;
+    ListGraph<double, double> listGraph;
+    for(unsigned i=0; i<iter; i++)
+    {
+        matrixGraph.randomGraph(1,20,0.1,0,0);
+        listGraph = matrixGraph;
+        std::vector<unsigned> matrixComponents = matrixGraph.stronglyConnectedComponents();
+        std::vector<unsigned> listComponents = listGraph.stronglyConnectedComponents();
+
+        ASSERT_EQ(matrixComponents, listComponents);
+        unsigned n = matrixGraph.size();
+        for(unsigned from=0; from<n; from++)
+        {
+            for(unsigned to=from+1; to<n; to++)
+            {
+                bool together = !matrixGraph.getPathVertices(from, to).empty() &&
+                                !matrixGraph.getPathVertices(to, from).empty();
+                ASSERT_EQ(together, matrixComponents[from]==matrixComponents[to]);
+            }
+        }
+        ASSERT_EQ(matrixComponents[0], 0);
+        ASSERT_EQ(matrixGraph.stronglyConnected(), *std::max_element(matrixComponents.begin(), matrixComponents.end())==0);
+    }
+}
+
+TEST(Graph, TestQueryCache)
+{
+    ListGraph<double, double> listGraph;
+    for(unsigned i=0; i<5; i++) listGraph.addVertex(0);
+    for(unsigned i=0; i<4; i++) listGraph.addEdge(i, i+1, 0);
+    listGraph.enableCache(2);
+
+    ASSERT_EQ(listGraph.getPathVertices(0, 4), std::vector<unsigned>({0,1,2,3,4}));
+    ASSERT_EQ(listGraph.getPathVertices(0, 4), std::vector<unsigned>({0,1,2,3,4}));
+    ASSERT_FALSE(listGraph.stronglyConnected());
+    ASSERT_FALSE(listGraph.stronglyConnected());
+    ASSERT_TRUE(listGraph.weaklyConnected());
+    ASSERT_EQ(listGraph.cacheStats().hits, 2);
+    ASSERT_EQ(listGraph.cacheStats().misses, 3);
+
+    //least recently used path is evicted
+    listGraph.getPathVertices(1, 4);
+    listGraph.getPathVertices(2, 4);
+    listGraph.getPathVertices(0, 4);
+    ASSERT_EQ(listGraph.cacheStats().misses, 6);
+
+    //any change of the structure invalidates stored results
+    listGraph.addEdge(4, 0, 0);
+    ASSERT_TRUE(listGraph.stronglyConnected());
+    listGraph.delEdge(0, 1);
+    ASSERT_EQ(listGraph.getPathVertices(0, 4), std::vector<unsigned>());
+    ASSERT_EQ(listGraph.cacheStats().misses, 8);
+
+    listGraph.disableCache();
+    listGraph.getPathVertices(0, 4);
+    ASSERT_EQ(listGraph.cacheStats().misses, 8);
+
+    //path lengths share stored routes
+    ListGraph<double, double> lengthGraph;
+    for(unsigned i=0; i<5; i++) lengthGraph.addVertex(0);
+    for(unsigned i=0; i<4; i++) lengthGraph.addEdge(i, i+1, 0);
+    lengthGraph.enableCache(2);
+    for(unsigned i=0; i<3; i++) ASSERT_EQ(lengthGraph.getPathLength(0, 4), 4u);
+    ASSERT_EQ(lengthGraph.cacheStats().hits, 2u);
+    ASSERT_EQ(lengthGraph.cacheStats().misses, 1u);
+    ASSERT_EQ(lengthGraph.getPathVertices(0, 4), std::vector<unsigned>({0,1,2,3,4}));
+    ASSERT_EQ(lengthGraph.cacheStats().hits, 3u);
+}
+
+TEST(Graph, TestConcurrentListGraph)
+{
+    unsigned n = 200;
+    ListGraph<double, double> listGraph;
+    for(unsigned i=0; i<n; i++) listGraph.addVertex(i);
+    ConcurrentListGraph<double, double> graph(listGraph);
+    auto empty = graph.snapshot();
+
+    //writer builds chain 0-->1-->...-->n-1, readers must always see a whole prefix of it
+    std::atomic<bool> done{false};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> readers;
+    for(unsigned t=0; t<3; t++)
+    {
+        readers.emplace_back([&]()
+        {
+            while(!done)
+            {
+                auto snapshot = graph.snapshot();
+                unsigned edgesN = snapshot->getEdges().size();
+                if(edgesN!=snapshot->version()-1) failed = true;
+                if(edgesN>0 && snapshot->getPathVertices(0, edgesN).size()!=edgesN+1) failed = true;
+                if(edgesN+1<n && !snapshot->getPathVertices(0, edgesN+1).empty()) failed = true;
+            }
+        });
+    }
+    for(unsigned i=0; i+1<n; i++)
+    {
+        graph.addEdge(i, i+1, i);
+        graph.publish();
+    }
+    done = true;
+    for(auto &i : readers) i.join();
+    ASSERT_FALSE(failed);
+
+    ASSERT_EQ(empty->size(), n);
+    ASSERT_TRUE(empty->getEdges().empty());
+    auto full = graph.snapshot();
+    ASSERT_EQ(full->getPathVertices(0, n-1).size(), n);
+    ASSERT_EQ((*full)(5, 6), 5);
+
+    graph.setEdge(5, 6, -1);
+    graph.delVertex(0);
+    ASSERT_EQ((*full)(5, 6), 5);
+    ASSERT_EQ(graph.snapshot()->size(), n);
+    graph.publish();
+    auto last = graph.snapshot();
+    ASSERT_EQ(last->size(), n-1);
+    ASSERT_EQ((*last)(4, 5), -1);
+    ASSERT_EQ((*last)(0), 1);
+    ASSERT_EQ(last->getPathVertices(0, n-2).size(), n-1);
+    ASSERT_EQ(full->size(), n);
+}
+
+TEST(Graph, TestReorder)
+{
+    unsigned iter = 100;
+
+    std::vector<ReorderStrategy> strategies = {ReorderStrategy::reverseCuthillMcKee, ReorderStrategy::degree,
+                                               ReorderStrategy::bfs, ReorderStrategy::gorderLite};
+    ListGraph<double, double> listGraph;
+    for(unsigned i=0; i<iter; i++)
+    {
+        listGraph.randomGraph(1,30,0.1,0,0);
+        unsigned n = listGraph.size();
+        for(unsigned j=0; j<n; j++) listGraph(j) = j;
+        for(auto &j : listGraph.getEdges()) listGraph(j[0], j[1]) = j[0]*100+j[1];
+        for(auto strategy : strategies)
+        {
+            ListGraph<double, double> reordered = listGraph;
+            std::vector<unsigned> permutation = reordered.reorder(strategy);
+
+            ASSERT_EQ(permutation.size(), n);
+            std::vector<unsigned> sorted = permutation;
+            std::sort(sorted.begin(), sorted.end());
+            for(unsigned j=0; j<n; j++) ASSERT_EQ(sorted[j], j);
+            for(unsigned j=0; j<n; j++) ASSERT_EQ(reordered(permutation[j]), j);
+            ASSERT_EQ(reordered.getEdges().size(), listGraph.getEdges().size());
+            for(auto &j : listGraph.getEdges())
+            {
+                ASSERT_TRUE(reordered.isEdgeExists(permutation[j[0]], permutation[j[1]]));
+                ASSERT_EQ(reordered(permutation[j[0]], permutation[j[1]]), j[0]*100+j[1]);
+            }
+        }
+    }
+}
+
+TEST(Graph, TestCompressedGraph)
+{
+    unsigned iter = 300;
+
+    ListGraph<double, double> listGraph;
+    for(unsigned i=0; i<iter; i++)
+    {
+        listGraph.randomGraph(2,40,i%2 ? 0.1 : 0.7,0,0);
+        CompressedGraph compressed = listGraph.compress();
+        unsigned n = listGraph.size();
+
+        ASSERT_EQ(compressed.size(), n);
+        ASSERT_EQ(compressed.edgesCount(), listGraph.getEdges().size());
+        ASSERT_EQ(compressed.getEdges(), listGraph.getEdges()); //rows of random graph are sorted
+        ASSERT_EQ(compressed.getPathVertices(0, n-1), listGraph.getPathVertices(0, n-1));
+        ASSERT_EQ(compressed.stronglyConnectedComponents(), listGraph.stronglyConnectedComponents());
+        for(unsigned j=0; j<n; j++)
+        {
+            ASSERT_EQ(compressed.isEdgeExists(0, j), listGraph.isEdgeExists(0, j));
+        }
+    }
+
+    //long rows with small and large gaps go through both decoding paths
+    for(unsigned i=0; i<1000; i++) listGraph.addVertex(0);
+    std::vector<unsigned> targets;
+    for(unsigned i=0; i<listGraph.size(); i+=(i%50<25 ? 1 : 300)) targets.push_back(i);
+    for(unsigned i : targets)
+    {
+        if(!listGraph.isEdgeExists(0, i)) listGraph.addEdge(0, i, 0);
+    }
+    CompressedGraph compressed = listGraph.compress();
+    MatrixGraph<double, double> matrixGraph(listGraph);
+    ASSERT_EQ(compressed.getEdges(), matrixGraph.compress().getEdges());
+    std::vector<unsigned> decoded;
+    compressed.forEachOut(0, [&decoded](unsigned u){ decoded.push_back(u); });
+    ASSERT_EQ(decoded.size(), compressed.outDegree(0));
+    ASSERT_TRUE(std::is_sorted(decoded.begin(), decoded.end()));
+    for(unsigned i : targets) ASSERT_TRUE(compressed.isEdgeExists(0, i));
+
+    //rows of later blocks are found through their block base
+    ListGraph<double, double> large;
+    large.randomGraph(300, 300, 0.05, 0, 0);
+    CompressedGraph compressedLarge = large.compress();
+    ASSERT_EQ(compressedLarge.getEdges(), large.getEdges());
+    for(unsigned i=0; i<large.size(); i++) ASSERT_EQ(compressedLarge.outDegree(i), large.outDegree(i));
+}
+
+TEST(Graph, TestAdaptiveGraph)
+{
+    unsigned iter = 50;
+
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    bool wasDense = false, wasSparse = false; //single runs may stay in one representation
+    for(unsigned i=0; i<iter; i++)
+    {
+        AdaptiveGraph<double, double> adaptiveGraph(0.3, 0.1, 4);
+        ListGraph<double, double> listGraph;
+        for(unsigned j=0; j<400; j++)
+        {
+            unsigned n = listGraph.size();
+            unsigned action = randInt(mt)%10;
+            //edges are added during the first half of steps and deleted during the second one
+            if(n<2 || action==0)
+            {
+                adaptiveGraph.addVertex(j);
+                listGraph.addVertex(j);
+            }
+            else if(action==1 && n>2)
+            {
+                unsigned vertex = randInt(mt)%n;
+                adaptiveGraph.delVertex(vertex);
+                listGraph.delVertex(vertex);
+            }
+            else
+            {
+                unsigned from = randInt(mt)%n, to = randInt(mt)%n;
+                bool exists = listGraph.isEdgeExists(from, to);
+                if(!exists && j<200)
+                {
+                    adaptiveGraph.addEdge(from, to, from*1000+to);
+                    listGraph.addEdge(from, to, from*1000+to);
+                }
+                else if(exists && j>=200)
+                {
+                    adaptiveGraph.delEdge(from, to);
+                    listGraph.delEdge(from, to);
+                }
+            }
+            n = listGraph.size();
+            ASSERT_EQ(adaptiveGraph.size(), n);
+            ASSERT_EQ(adaptiveGraph.edgesCount(), listGraph.getEdges().size());
+            if(n>=4)
+            {
+                double density = (double)adaptiveGraph.edgesCount()/(n*n);
+                if(density>=0.3)
+                {
+                    ASSERT_TRUE(adaptiveGraph.isDense());
+                }
+                if(density<=0.1)
+                {
+                    ASSERT_FALSE(adaptiveGraph.isDense());
+                }
+            }
+            if(adaptiveGraph.isDense()) wasDense = true;
+            else wasSparse = true;
+        }
+        std::vector<std::vector<unsigned>> edges = listGraph.getEdges();
+        std::vector<std::vector<unsigned>> adaptiveEdges = adaptiveGraph.getEdges();
+        std::sort(edges.begin(), edges.end());
+        std::sort(adaptiveEdges.begin(), adaptiveEdges.end());
+        ASSERT_EQ(adaptiveEdges, edges);
+        for(auto &j : edges) ASSERT_EQ(adaptiveGraph(j[0], j[1]), listGraph(j[0], j[1]));
+        for(unsigned j=0; j<listGraph.size(); j++) ASSERT_EQ(adaptiveGraph(j), listGraph(j));
+        ASSERT_EQ(adaptiveGraph.stronglyConnectedComponents(), listGraph.stronglyConnectedComponents());
+        ASSERT_EQ(adaptiveGraph.weaklyConnected(), listGraph.weaklyConnected());
+        AdaptiveGraph<double, double> copy = adaptiveGraph;
+        ASSERT_EQ(copy.getEdges().size(), edges.size());
+    }
+    ASSERT_TRUE(wasDense && wasSparse);
+}
+
+TEST(Graph, TestStaticAlgorithms)
+{
+    unsigned iter = 200;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<double, double> listGraph;
+        randomFill(listGraph, 2+i%40, i%2 ? 0.05 : 0.3, 0.0, 0.0, mt);
+        MatrixGraph<double, double> matrixGraph(listGraph);
+        AdjacencyArrays arrays = transposed(transposed(listGraph));
+        unsigned n = listGraph.size();
+
+        ASSERT_EQ(arrays.size(), n);
+        ASSERT_EQ(pathVertices(arrays, 0, n-1), listGraph.getPathVertices(0, n-1));
+        ASSERT_EQ(pathVertices(matrixGraph.compress(), n-1, 0), matrixGraph.getPathVertices(n-1, 0));
+        ASSERT_EQ(strongComponents(arrays), listGraph.stronglyConnectedComponents());
+        ASSERT_EQ(strongComponents(matrixGraph, reversedView(matrixGraph)), strongComponents(listGraph));
+        ASSERT_EQ(isStronglyConnected(arrays), listGraph.stronglyConnected());
+        ASSERT_EQ(isWeaklyConnected(matrixGraph), listGraph.weaklyConnected());
+
+        std::vector<bool> visitedBreadth(n, false), visitedDepth(n, false);
+        unsigned breadthN = 0, depthN = 0;
+        breadthFirst(listGraph, 0, [&](unsigned v){ visitedBreadth[v] = true; breadthN++; });
+        depthFirst(matrixGraph, 0, [&](unsigned v){ visitedDepth[v] = true; depthN++; });
+        ASSERT_EQ(visitedBreadth, visitedDepth);
+        ASSERT_EQ(breadthN, depthN);
+        for(unsigned j=0; j<n; j++)
+        {
+            ASSERT_EQ(visitedBreadth[j], j==0 || pathLength(listGraph, 0, j)>0);
+        }
+    }
+}
+
+TEST(Graph, TestVertexStore)
+{
+    unsigned iter = 2000;
+
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    ListGraph<std::vector<int>, double> listGraph;
+    std::vector<std::vector<int>> payloads; //expected vertices data
+    std::vector<double> weights; //expected attribute values
+    VertexAttribute<double> weight = listGraph.addVertexAttribute(0.5);
+    for(unsigned i=0; i<iter; i++)
+    {
+        unsigned n = listGraph.size();
+        if(n<2 || randInt(mt)%3)
+        {
+            listGraph.addVertex(std::vector<int>(i%7, i));
+            payloads.push_back(std::vector<int>(i%7, i));
+            weights.push_back(0.5);
+            if(i%2) listGraph.addEdge(n, randInt(mt)%n, i);
+        }
+        else
+        {
+            unsigned vertex = randInt(mt)%n;
+            listGraph.delVertex(vertex);
+            payloads.erase(payloads.begin()+vertex);
+            weights.erase(weights.begin()+vertex);
+        }
+        n = listGraph.size();
+        unsigned changed = randInt(mt)%n;
+        listGraph.vertexAttribute(weight, changed) = i;
+        weights[changed] = i;
+        ASSERT_EQ(n, payloads.size());
+        for(unsigned j=0; j<n; j++)
+        {
+            ASSERT_EQ(listGraph(j), payloads[j]);
+            ASSERT_EQ(listGraph.vertexAttribute(weight, j), weights[j]);
+        }
+    }
+
+    //payloads and attributes follow vertices when they are renumbered
+    std::vector<unsigned> permutation = listGraph.reorder(ReorderStrategy::degree);
+    ListGraph<std::vector<int>, double> copy = listGraph;
+    for(unsigned j=0; j<payloads.size(); j++)
+    {
+        ASSERT_EQ(copy(permutation[j]), payloads[j]);
+        ASSERT_EQ(copy.vertexAttribute(weight, permutation[j]), weights[j]);
+    }
+
+    //attributes of adaptive graph survive switching representation
+    AdaptiveGraph<int, int> adaptiveGraph(0.3, 0.1, 4);
+    VertexAttribute<unsigned> label = adaptiveGraph.addVertexAttribute(0u);
+    for(unsigned j=0; j<8; j++)
+    {
+        adaptiveGraph.addVertex(j);
+        adaptiveGraph.vertexAttribute(label, j) = j*j;
+    }
+    for(unsigned j=0; j<8; j++)
+    {
+        for(unsigned k=0; k<8; k++) adaptiveGraph.addEdge(j, k, 0);
+    }
+    ASSERT_TRUE(adaptiveGraph.isDense());
+    adaptiveGraph.delVertex(2);
+    AdaptiveGraph<int, int> adaptiveCopy = adaptiveGraph;
+    for(unsigned j=0; j<7; j++)
+    {
+        ASSERT_EQ(adaptiveCopy.vertexAttribute(label, j), (j<2 ? j : j+1)*(j<2 ? j : j+1));
+    }
+}
+
+TEST(Graph, TestEdgePayload)
+{
+    unsigned iter = 3000;
+
+    static_assert(sizeof(EdgePayload<double>)==sizeof(double), "double must be stored inline");
+    static_assert(sizeof(EdgePayload<std::vector<int>>)==sizeof(void*), "vector must be stored on heap");
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    MatrixGraph<int, double> matrixGraph;
+    MatrixGraph<int, std::vector<int>> heavyMatrixGraph;
+    ListGraph<int, std::vector<int>> heavyListGraph;
+    for(unsigned i=0; i<iter; i++)
+    {
+        unsigned n = matrixGraph.size();
+        unsigned action = randInt(mt)%20;
+        //vertices count goes over 64 and back, so presence rows change their length
+        if(n<2 || (action<4 && i%1000<600))
+        {
+            matrixGraph.addVertex(i);
+            heavyMatrixGraph.addVertex(i);
+            heavyListGraph.addVertex(i);
+        }
+        else if(action<5)
+        {
+            unsigned vertex = randInt(mt)%n;
+            matrixGraph.delVertex(vertex);
+            heavyMatrixGraph.delVertex(vertex);
+            heavyListGraph.delVertex(vertex);
+        }
+        else
+        {
+            unsigned from = randInt(mt)%n, to = randInt(mt)%n;
+            if(matrixGraph.isEdgeExists(from, to))
+            {
+                matrixGraph.delEdge(from, to);
+                heavyMatrixGraph.delEdge(from, to);
+                heavyListGraph.delEdge(from, to);
+            }
+            else
+            {
+                matrixGraph.addEdge(from, to, i+0.5);
+                heavyMatrixGraph.addEdge(from, to, std::vector<int>(3, i));
+                heavyListGraph.addEdge(from, to, std::vector<int>(3, i));
+            }
+        }
+        n = matrixGraph.size();
+        std::vector<std::vector<unsigned>> edges = matrixGraph.getEdges();
+        ASSERT_EQ(heavyMatrixGraph.getEdges(), edges);
+        ASSERT_EQ(heavyListGraph.getEdges().size(), edges.size());
+        for(auto &j : edges)
+        {
+            ASSERT_TRUE(heavyListGraph.isEdgeExists(j[0], j[1]));
+            ASSERT_EQ((int)matrixGraph(j[0], j[1]), heavyMatrixGraph(j[0], j[1])[0]);
+            ASSERT_EQ(heavyMatrixGraph(j[0], j[1]), heavyListGraph(j[0], j[1]));
+        }
+    }
+    MatrixGraph<int, std::vector<int>> heavyCopy = heavyMatrixGraph;
+    MatrixGraph<int, std::vector<int>> converted(heavyListGraph);
+    heavyMatrixGraph.clear();
+    ASSERT_EQ(heavyCopy.getEdges(), converted.getEdges());
+}
+
+TEST(Graph, TestListGraphDegrees)
+{
+    unsigned iter = 3000;
+
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    ListGraph<int, int> indexedGraph, plainGraph;
+    MatrixGraph<int, int> matrixGraph;
+    indexedGraph.setOrderInsensitive(true);
+    indexedGraph.enableReverseIndex();
+    for(unsigned i=0; i<iter; i++)
+    {
+        unsigned n = matrixGraph.size();
+        unsigned action = randInt(mt)%20;
+        if(n<2 || action==0)
+        {
+            indexedGraph.addVertex(i);
+            plainGraph.addVertex(i);
+            matrixGraph.addVertex(i);
+        }
+        else if(action==1 && n>2)
+        {
+            unsigned vertex = randInt(mt)%n;
+            indexedGraph.delVertex(vertex);
+            plainGraph.delVertex(vertex);
+            matrixGraph.delVertex(vertex);
+        }
+        else if(action==2 && i%500==2)
+        {
+            //index can be switched at any time
+            indexedGraph.disableReverseIndex();
+            ASSERT_FALSE(indexedGraph.hasReverseIndex());
+            indexedGraph.enableReverseIndex();
+        }
+        else
+        {
+            unsigned from = randInt(mt)%n, to = randInt(mt)%n;
+            if(matrixGraph.isEdgeExists(from, to))
+            {
+                indexedGraph.delEdge(from, to);
+                plainGraph.delEdge(from, to);
+                matrixGraph.delEdge(from, to);
+            }
+            else
+            {
+                indexedGraph.addEdge(from, to, from*1000+to);
+                plainGraph.addEdge(from, to, from*1000+to);
+                matrixGraph.addEdge(from, to, from*1000+to);
+            }
+        }
+        n = matrixGraph.size();
+        std::vector<std::vector<unsigned>> edges = indexedGraph.getEdges();
+        std::sort(edges.begin(), edges.end());
+        ASSERT_EQ(edges, matrixGraph.getEdges());
+        ASSERT_EQ(plainGraph.getEdges().size(), edges.size());
+        std::vector<unsigned> inDegrees(n, 0), outDegrees(n, 0);
+        for(auto &j : edges)
+        {
+            outDegrees[j[0]]++;
+            inDegrees[j[1]]++;
+            ASSERT_EQ(indexedGraph(j[0], j[1]), matrixGraph(j[0], j[1]));
+        }
+        for(unsigned j=0; j<n; j++)
+        {
+            ASSERT_EQ(indexedGraph.inDegree(j), inDegrees[j]);
+            ASSERT_EQ(indexedGraph.outDegree(j), outDegrees[j]);
+            ASSERT_EQ(plainGraph.inDegree(j), inDegrees[j]);
+        }
+    }
+    ListGraph<int, int> copy = indexedGraph;
+    ASSERT_TRUE(copy.hasReverseIndex());
+    copy.reorder(ReorderStrategy::bfs);
+    for(unsigned j=0; j<copy.size(); j++)
+    {
+        for(auto &k : copy.getEdges()) if(k[1]==j) copy.delEdge(k[0], k[1]);
+        ASSERT_EQ(copy.inDegree(j), 0u);
+    }
+}
+
+TEST(Graph, TestReverseIndex)
+{
+    unsigned iter = 200;
+
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> plainGraph;
+        plainGraph.randomGraph(2, 40, i%2 ? 0.04 : 0.2, 0, 0);
+        ListGraph<int, int> indexedGraph = plainGraph;
+        indexedGraph.setOrderInsensitive(i%4<2);
+        indexedGraph.enableReverseIndex();
+        for(unsigned j=0; j<3 && plainGraph.size()>2; j++)
+        {
+            unsigned vertex = randInt(mt)%plainGraph.size();
+            plainGraph.delVertex(vertex);
+            indexedGraph.delVertex(vertex);
+        }
+        unsigned n = plainGraph.size();
+
+        AdjacencyArrays reversed = transposed(plainGraph);
+        for(unsigned j=0; j<n; j++)
+        {
+            std::vector<unsigned> expected, found;
+            reversed.forEachOut(j, [&expected](unsigned u){ expected.push_back(u); });
+            indexedGraph.forEachIn(j, [&found](unsigned u){ found.push_back(u); });
+            std::sort(found.begin(), found.end());
+            ASSERT_EQ(found, expected);
+        }
+        ASSERT_EQ(indexedGraph.stronglyConnectedComponents(), plainGraph.stronglyConnectedComponents());
+        ASSERT_EQ(indexedGraph.stronglyConnected(), plainGraph.stronglyConnected());
+        ASSERT_EQ(indexedGraph.weaklyConnected(), plainGraph.weaklyConnected());
+        ASSERT_EQ(pathLength(reversedView(indexedGraph), n-1, 0), pathLength(reversed, n-1, 0)); //same length, ties may differ
+    }
+}
+
+TEST(Graph, TestSubgraphView)
+{
+    unsigned iter = 300;
+
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, double> listGraph;
+        listGraph.randomGraph(2, 30, i%2 ? 0.1 : 0.4, 0, 0);
+        unsigned n = listGraph.size();
+        std::vector<std::vector<unsigned>> edges = listGraph.getEdges();
+        for(auto &j : edges) listGraph(j[0], j[1]) = randInt(mt)%100;
+        std::vector<bool> mask(n);
+        for(unsigned j=0; j<n; j++) mask[j] = randInt(mt)%4!=0;
+        mask[0] = true;
+        double threshold = 60;
+        auto cheap = [threshold](unsigned, unsigned, double cost){ return cost<threshold; };
+
+        //same subgraph built by copying
+        ListGraph<int, double> copied, compact;
+        for(unsigned j=0; j<n; j++) copied.addVertex(0);
+        for(auto &j : edges)
+        {
+            if(mask[j[0]] && mask[j[1]] && listGraph(j[0], j[1])<threshold) copied.addEdge(j[0], j[1], listGraph(j[0], j[1]));
+        }
+        compact = copied;
+        for(unsigned j=n; j-->0;) if(!mask[j]) compact.delVertex(j);
+
+        auto view = subgraphView(listGraph, mask, cheap);
+        ASSERT_EQ(presentVertices(view), compact.size());
+        ASSERT_EQ(pathVertices(view, 0, n-1), copied.getPathVertices(0, n-1));
+        ASSERT_EQ(strongComponents(view), copied.stronglyConnectedComponents());
+        ASSERT_EQ(isStronglyConnected(view), compact.stronglyConnected());
+        ASSERT_EQ(isWeaklyConnected(view), compact.weaklyConnected());
+        std::vector<std::vector<unsigned>> viewEdges;
+        for(unsigned j=0; j<n; j++)
+        {
+            view.forEachOutEdge(j, [&](unsigned u, double cost)
+            {
+                ASSERT_LT(cost, threshold);
+                viewEdges.push_back({j, u});
+            });
+        }
+        ASSERT_EQ(viewEdges, copied.getEdges());
+
+        //views over views and over other storages
+        MatrixGraph<int, double> matrixGraph(listGraph);
+        auto filtered = filteredView(matrixGraph, cheap);
+        auto both = subgraphView(filtered, mask);
+        ASSERT_EQ(strongComponents(both), copied.stronglyConnectedComponents());
+        auto masked = subgraphView(matrixGraph, mask);
+        auto nested = filteredView(masked, cheap); //mask inside the filter
+        ASSERT_EQ(presentVertices(nested), compact.size());
+        ASSERT_EQ(isStronglyConnected(nested), compact.stronglyConnected());
+        ASSERT_EQ(isWeaklyConnected(nested), compact.weaklyConnected());
+        ASSERT_EQ(strongComponents(nested), copied.stronglyConnectedComponents());
+        ASSERT_EQ(reachedCount(subgraphView(listGraph, mask), 0), reachedCount(subgraphView(matrixGraph, mask), 0));
+    }
+
+    //vertex hidden by the inner mask stays hidden behind a filter over the view
+    ListGraph<int, double> cycle;
+    for(unsigned i=0; i<4; i++) cycle.addVertex(0);
+    cycle.addEdge(0, 1, 0);
+    cycle.addEdge(1, 2, 0);
+    cycle.addEdge(2, 3, 0);
+    cycle.addEdge(3, 1, 0);
+    std::vector<bool> mask = {false, true, true, true};
+    auto inner = subgraphView(cycle, mask);
+    auto outer = filteredView(inner, AllEdges());
+    ASSERT_EQ(presentVertices(outer), 3u);
+    ASSERT_FALSE(outer.contains(0));
+    ASSERT_EQ(firstPresentVertex(outer), 1u);
+    ASSERT_TRUE(isStronglyConnected(inner));
+    ASSERT_TRUE(isStronglyConnected(outer));
+}
+
+TEST(Graph, TestGraphJournal)
+{
+    unsigned iter = 2000;
+
+    std::string path = "graph_journal_test";
+    std::remove((path+".log").c_str());
+    std::remove((path+".snapshot").c_str());
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    ListGraph<std::vector<int>, double> expected;
+    auto sameGraphs = [&expected](const ListGraph<std::vector<int>, double> &restored)
+    {
+        ASSERT_EQ(restored.size(), expected.size());
+        ASSERT_EQ(restored.getEdges(), expected.getEdges());
+        for(unsigned i=0; i<expected.size(); i++) ASSERT_EQ(restored(i), expected(i));
+        for(auto &i : expected.getEdges()) ASSERT_EQ(restored(i[0], i[1]), expected(i[0], i[1]));
+    };
+    {
+        ListGraph<std::vector<int>, double> listGraph;
+        GraphJournal<std::vector<int>, double> journal(listGraph, path, 300);
+        ASSERT_TRUE(journal.recover());
+        ASSERT_EQ(listGraph.size(), 0u);
+        for(unsigned i=0; i<iter; i++)
+        {
+            unsigned n = listGraph.size();
+            unsigned action = randInt(mt)%20;
+            if(n<2 || action==0)
+            {
+                ASSERT_TRUE(journal.addVertex(std::vector<int>(i%4, i)));
+                expected.addVertex(std::vector<int>(i%4, i));
+            }
+            else if(action==1)
+            {
+                unsigned vertex = randInt(mt)%n;
+                ASSERT_TRUE(journal.delVertex(vertex));
+                expected.delVertex(vertex);
+            }
+            else if(action==2)
+            {
+                unsigned vertex = randInt(mt)%n;
+                ASSERT_TRUE(journal.setVertex(vertex, {(int)i}));
+                expected(vertex) = {(int)i};
+            }
+            else
+            {
+                unsigned from = randInt(mt)%n, to = randInt(mt)%n;
+                if(!expected.isEdgeExists(from, to))
+                {
+                    ASSERT_TRUE(journal.addEdge(from, to, i*0.5));
+                    expected.addEdge(from, to, i*0.5);
+                }
+                else if(action%2)
+                {
+                    ASSERT_TRUE(journal.delEdge(from, to));
+                    expected.delEdge(from, to);
+                }
+                else
+                {
+                    ASSERT_TRUE(journal.setEdge(from, to, -1.0*i));
+                    expected(from, to) = -1.0*i;
+                }
+            }
+            ASSERT_LT(journal.logRecords(), 300u); //snapshots are taken automatically
+        }
+        sameGraphs(listGraph);
+    }
+
+    //restart: last snapshot and log tail are loaded
+    ListGraph<std::vector<int>, double> restored;
+    restored.enableReverseIndex();
+    {
+        GraphJournal<std::vector<int>, double> journal(restored, path);
+        ASSERT_TRUE(journal.recover());
+        sameGraphs(restored);
+        ASSERT_TRUE(journal.addVertex({1, 2, 3}));
+        expected.addVertex({1, 2, 3});
+        ASSERT_TRUE(journal.addEdge(0, expected.size()-1, 7.5));
+        expected.addEdge(0, expected.size()-1, 7.5);
+    }
+    ASSERT_EQ(restored.inDegree(expected.size()-1), 1u);
+
+    //torn last record is dropped, the rest is replayed
+    {
+        std::ofstream log(path+".log", std::ios::binary|std::ios::app);
+        log.put(3);
+        log.put((char)0x81);
+    }
+    {
+        GraphJournal<std::vector<int>, double> journal(restored, path);
+        ASSERT_TRUE(journal.recover());
+        sameGraphs(restored);
+        ASSERT_TRUE(journal.delEdge(0, expected.size()-1));
+        expected.delEdge(0, expected.size()-1);
+        ASSERT_TRUE(journal.snapshot());
+        ASSERT_EQ(journal.logRecords(), 0u);
+    }
+    {
+        GraphJournal<std::vector<int>, double> journal(restored, path);
+        ASSERT_TRUE(journal.recover());
+        sameGraphs(restored);
+    }
+
+    //record which doesn't match the graph ends the replay like a torn one: deleting or setting a missing edge,
+    //adding an existing one (valid records before it are kept, the tail is cut off)
+    unsigned missing = expected.size()-1;
+    std::vector<unsigned> existing = expected.getEdges()[0];
+    for(unsigned i=0; i<3; i++)
+    {
+        std::string bytes;
+        bytes.push_back(5); //setVertex 0
+        journalWriteNumber(bytes, 0);
+        JournalCodec<std::vector<int>>::write(bytes, {(int)i});
+        bytes.push_back(3); //addEdge of an edge which is deleted again below
+        journalWriteNumber(bytes, missing);
+        journalWriteNumber(bytes, 0);
+        JournalCodec<double>::write(bytes, 1.5);
+        bytes.push_back(4);
+        journalWriteNumber(bytes, missing);
+        journalWriteNumber(bytes, 0);
+        bytes.push_back(i==0 ? 4 : i==1 ? 6 : 3); //bad record
+        journalWriteNumber(bytes, i==2 ? existing[0] : 0);
+        journalWriteNumber(bytes, i==2 ? existing[1] : missing);
+        if(i>0) JournalCodec<double>::write(bytes, 2.5);
+        bytes.push_back(1); //addVertex after the bad record is not applied
+        JournalCodec<std::vector<int>>::write(bytes, {});
+        {
+            std::ofstream log(path+".log", std::ios::binary|std::ios::app);
+            log.write(bytes.data(), bytes.size());
+        }
+        expected(0) = {(int)i};
+        GraphJournal<std::vector<int>, double> journal(restored, path);
+        ASSERT_TRUE(journal.recover());
+        sameGraphs(restored);
+        ASSERT_EQ(journal.logRecords(), 3*(i+1));
+    }
+    {
+        GraphJournal<std::vector<int>, double> journal(restored, path);
+        ASSERT_TRUE(journal.recover());
+        sameGraphs(restored);
+        ASSERT_EQ(journal.logRecords(), 9u);
+    }
+
+    //corrupt vertex count of the snapshot is rejected instead of being allocated
+    {
+        std::string bytes("GRAPHSNP", 8);
+        JournalCodec<unsigned long long>::write(bytes, 1);
+        journalWriteNumber(bytes, 1ull<<40);
+        std::ofstream snapshot(path+".snapshot", std::ios::binary|std::ios::trunc);
+        snapshot.write(bytes.data(), bytes.size());
+    }
+    {
+        GraphJournal<std::vector<int>, double> journal(restored, path);
+        ASSERT_FALSE(journal.recover());
+    }
+    std::remove((path+".log").c_str());
+    std::remove((path+".snapshot").c_str());
+}
+
+TEST(Graph, TestBatchAndDiff)
+{
+    unsigned iter = 200;
+
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> batched, expected;
+        batched.randomGraph(2, 60, 0.1, 0, 1);
+        if(i%2)
+        {
+            batched.setOrderInsensitive(true);
+            batched.enableReverseIndex();
+        }
+        expected = batched;
+        unsigned n = batched.size();
+
+        //random batch: some existing edges are deleted or replaced, some new ones are added
+        EdgeBatch<int> batch;
+        for(auto &j : expected.getEdges())
+        {
+            unsigned action = randInt(mt)%4;
+            if(action==0) batch.deletes.push_back({j[0], j[1]});
+            if(action==1)
+            {
+                batch.deletes.push_back({j[0], j[1]});
+                batch.inserts.push_back({j[0], j[1], (int)i});
+            }
+        }
+        for(unsigned j=0; j<n; j++)
+        {
+            unsigned to = randInt(mt)%n;
+            if(!expected.isEdgeExists(j, to)) batch.inserts.push_back({j, to, (int)j});
+        }
+        for(auto &j : batch.deletes) expected.delEdge(j.from, j.to);
+        for(auto &j : batch.inserts) expected.addEdge(j.from, j.to, j.data);
+        ListGraph<int, int> original = batched;
+        batched.applyBatch(batch.inserts, batch.deletes);
+
+        std::vector<std::vector<unsigned>> edges = batched.getEdges(), expectedEdges = expected.getEdges();
+        std::sort(edges.begin(), edges.end());
+        std::sort(expectedEdges.begin(), expectedEdges.end());
+        ASSERT_EQ(edges, expectedEdges);
+        for(auto &j : edges) ASSERT_EQ(batched(j[0], j[1]), expected(j[0], j[1]));
+        for(unsigned j=0; j<n; j++) ASSERT_EQ(batched.inDegree(j), expected.inDegree(j));
+        if(batched.hasReverseIndex())
+        {
+            ASSERT_EQ(batched.stronglyConnectedComponents(), expected.stronglyConnectedComponents());
+        }
+
+        //diff of original and result gives an equivalent batch
+        EdgeBatch<int> changes = diff(original, batched);
+        ASSERT_LE(changes.deletes.size(), batch.deletes.size());
+        original.applyBatch(changes);
+        ASSERT_EQ(diff(original, batched).inserts.size(), 0u);
+        ASSERT_EQ(diff(original, MatrixGraph<int, int>(expected)).deletes.size(), 0u);
+    }
+}
+
+struct CountingGraph //counts scanned rows
+{
+    const ListGraph<int, int> &graph;
+    unsigned &scans;
+    unsigned size() const {return graph.size();}
+    template <class Function>
+    void forEachOut(unsigned vertex, const Function &function) const
+    {
+        scans++;
+        graph.forEachOut(vertex, function);
+    }
+};
+
+TEST(Graph, TestTraversalCursors)
+{
+    unsigned iter = 200;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> listGraph;
+        listGraph.randomGraph(2, 50, i%2 ? 0.05 : 0.2, 0, 0);
+        MatrixGraph<int, int> matrixGraph(listGraph);
+        unsigned n = listGraph.size();
+
+        //whole traversals return the same vertices as the eager ones
+        std::vector<unsigned> eager, lazy;
+        breadthFirst(listGraph, 0, [&eager](unsigned v){ eager.push_back(v); });
+        std::vector<unsigned> depths(n, 0);
+        for(const TraversalStep &step : breadthFirstCursor(matrixGraph, 0))
+        {
+            lazy.push_back(step.vertex);
+            depths[step.vertex] = step.depth;
+            if(step.vertex!=0)
+            {
+                ASSERT_TRUE(listGraph.isEdgeExists(step.parent, step.vertex));
+                ASSERT_EQ(step.depth, depths[step.parent]+1);
+                ASSERT_EQ(step.depth, pathLength(listGraph, 0, step.vertex)); //BFS depth is distance
+            }
+        }
+        ASSERT_EQ(lazy, eager);
+        eager.clear();
+        lazy.clear();
+        depthFirst(listGraph, 0, [&eager](unsigned v){ eager.push_back(v); });
+        auto depthCursor = depthFirstCursor(listGraph, 0);
+        for(const TraversalStep &step : depthCursor)
+        {
+            lazy.push_back(step.vertex);
+            ASSERT_TRUE(step.vertex==0 || listGraph.isEdgeExists(step.parent, step.vertex));
+        }
+        ASSERT_EQ(lazy, eager);
+
+        //abandoned cursor is resumed where it stopped
+        BreadthFirstCursor<ListGraph<int, int>> cursor(listGraph, 0);
+        std::vector<unsigned> resumed;
+        for(const TraversalStep &step : cursor)
+        {
+            resumed.push_back(step.vertex);
+            if(resumed.size()==3) break;
+        }
+        TraversalStep step;
+        while(cursor.next(step)) resumed.push_back(step.vertex);
+        std::vector<unsigned> full;
+        breadthFirst(listGraph, 0, [&full](unsigned v){ full.push_back(v); });
+        ASSERT_EQ(resumed, full);
+        ASSERT_FALSE(cursor.next(step));
+    }
+
+    //first k vertices don't scan rows which are not needed
+    ListGraph<int, int> star;
+    for(unsigned i=0; i<1000; i++) star.addVertex(0);
+    for(unsigned i=1; i<1000; i++) star.addEdge(0, i, 0);
+    unsigned scans = 0;
+    CountingGraph counting{star, scans};
+    auto cursor = breadthFirstCursor(counting, 0);
+    TraversalStep step;
+    for(unsigned i=0; i<10; i++) ASSERT_TRUE(cursor.next(step));
+    ASSERT_EQ(scans, 1u);
+    ASSERT_EQ(step.depth, 1u);
+    auto depthCursor = depthFirstCursor(counting, 0);
+    for(unsigned i=0; i<3; i++) ASSERT_TRUE(depthCursor.next(step));
+    ASSERT_EQ(scans, 1u+2u); //start and one leaf
+}
+
+TEST(Graph, TestPageRank)
+{
+    unsigned iter = 20;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(2, 300, 0.02, 0, 0);
+        unsigned n = graph.size();
+
+        //straightforward push iterations as reference
+        PageRankOptions options;
+        options.tolerance = 1e-12;
+        options.maxIterations = 200;
+        std::vector<double> expected(n, 1.0/n);
+        for(unsigned j=0; j<options.maxIterations; j++)
+        {
+            std::vector<double> next(n, 0);
+            double lost = 0;
+            for(unsigned v=0; v<n; v++)
+            {
+                unsigned degree = graph.outDegree(v);
+                if(degree==0) lost += expected[v];
+                graph.forEachOut(v, [&](unsigned u){ next[u] += expected[v]/degree; });
+            }
+            for(unsigned v=0; v<n; v++) next[v] = (1-options.damping)/n+options.damping*(next[v]+lost/n);
+            expected = next;
+        }
+
+        std::vector<double> ranks = pageRank(graph, options);
+        ASSERT_EQ(ranks.size(), n);
+        double sum = 0;
+        for(unsigned v=0; v<n; v++)
+        {
+            ASSERT_NEAR(ranks[v], expected[v], 1e-9);
+            sum += ranks[v];
+        }
+        ASSERT_NEAR(sum, 1, 1e-9);
+        ASSERT_EQ(pageRank(graph.compress(), options), ranks);
+
+        //personalized ranks are zero outside of vertices reachable from sources
+        std::vector<double> personal = personalizedPageRank(graph, {0, 1}, options);
+        sum = 0;
+        for(unsigned v=0; v<n; v++)
+        {
+            bool reached = v<2 || graph.getPathLength(0, v) || graph.getPathLength(1, v);
+            ASSERT_TRUE(reached || personal[v]==0);
+            sum += personal[v];
+        }
+        ASSERT_NEAR(sum, 1, 1e-9);
+    }
+
+    //cycle: every vertex has the same rank whatever the damping is
+    ListGraph<int, int> cycle;
+    for(unsigned i=0; i<5; i++) cycle.addVertex(0);
+    for(unsigned i=0; i<5; i++) cycle.addEdge(i, (i+1)%5, 0);
+    for(double i : pageRank(cycle)) ASSERT_NEAR(i, 0.2, 1e-12);
+}
+
+TEST(Graph, TestTriangles)
+{
+    unsigned iter = 40;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        double edgeProb = i%2 ? 0.5 : 0.05; //dense and sparse graphs
+        graph.randomGraph(1, 90, edgeProb, 0, 0);
+        if(graph.size()>1 && !graph.isEdgeExists(1, 1)) graph.addEdge(1, 1, 0); //self-loops are ignored
+        unsigned n = graph.size();
+
+        //brute force over all triples
+        auto linked = [&](unsigned a, unsigned b){ return graph.isEdgeExists(a, b) || graph.isEdgeExists(b, a); };
+        unsigned long long expected = 0;
+        std::vector<unsigned long long> expectedVertex(n, 0);
+        std::vector<unsigned> degree(n, 0);
+        for(unsigned a=0; a<n; a++)
+        {
+            for(unsigned b=a+1; b<n; b++)
+            {
+                if(!linked(a, b)) continue;
+                degree[a]++;
+                degree[b]++;
+                for(unsigned c=b+1; c<n; c++)
+                {
+                    if(linked(a, c) && linked(b, c))
+                    {
+                        expected++;
+                        expectedVertex[a]++;
+                        expectedVertex[b]++;
+                        expectedVertex[c]++;
+                    }
+                }
+            }
+        }
+
+        ASSERT_EQ(countTriangles(graph, TriangleStrategy::merge), expected);
+        ASSERT_EQ(countTriangles(graph, TriangleStrategy::bitset), expected);
+        ASSERT_EQ(graph.countTriangles(), expected);
+        MatrixGraph<int, int> matrix(graph);
+        ASSERT_EQ(matrix.countTriangles(), expected);
+        ASSERT_EQ(countTriangles(transposed(graph)), expected); //directed arrays are symmetrized first
+        ASSERT_EQ(vertexTriangles(graph, TriangleStrategy::merge), expectedVertex);
+        ASSERT_EQ(vertexTriangles(graph, TriangleStrategy::bitset), expectedVertex);
+        std::vector<double> coefficients = graph.clusteringCoefficients();
+        ASSERT_EQ(coefficients, matrix.clusteringCoefficients());
+        for(unsigned v=0; v<n; v++)
+        {
+            double pairs = degree[v]*(degree[v]-1.0)/2;
+            ASSERT_DOUBLE_EQ(coefficients[v], pairs ? expectedVertex[v]/pairs : 0);
+        }
+    }
+}
+
+TEST(Graph, TestCoreNumbers)
+{
+    unsigned iter = 40;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(1, 120, i%2 ? 0.3 : 0.03, 0, 0);
+        unsigned n = graph.size();
+
+        //reference: k-core is what is left after deleting vertices with less than k neighbours while there are any
+        std::vector<unsigned> expected(n, 0);
+        for(unsigned k=1; k<=n; k++)
+        {
+            std::vector<bool> alive(n, true);
+            bool changed = true;
+            while(changed)
+            {
+                changed = false;
+                for(unsigned v=0; v<n; v++)
+                {
+                    if(!alive[v]) continue;
+                    unsigned degree = 0;
+                    for(unsigned u=0; u<n; u++)
+                    {
+                        if(u!=v && alive[u] && (graph.isEdgeExists(v, u) || graph.isEdgeExists(u, v))) degree++;
+                    }
+                    if(degree<k)
+                    {
+                        alive[v] = false;
+                        changed = true;
+                    }
+                }
+            }
+            if(std::find(alive.begin(), alive.end(), true)==alive.end()) break;
+            for(unsigned v=0; v<n; v++)
+            {
+                if(alive[v]) expected[v] = k;
+            }
+        }
+
+        std::vector<unsigned> cores = coreNumbers(graph);
+        ASSERT_EQ(cores, expected);
+        ASSERT_EQ(parallelCoreNumbers(graph), expected);
+        ASSERT_EQ(coreNumbers(MatrixGraph<int, int>(graph)), expected);
+        ASSERT_EQ(coreNumbers(transposed(graph)), expected); //directed arrays are symmetrized first
+
+        //the mask gives a view of the core without touching the graph
+        unsigned k = *std::max_element(cores.begin(), cores.end());
+        std::vector<bool> mask = coreMask(cores, k);
+        AdjacencyArrays core = undirectedArrays(subgraphView(graph, mask));
+        for(unsigned v=0; v<n; v++)
+        {
+            ASSERT_EQ(mask[v], cores[v]==k);
+            ASSERT_TRUE(!mask[v] || core.offsets[v+1]-core.offsets[v]>=k);
+        }
+    }
+}
+
+TEST(Graph, TestSpanningForest)
+{
+    unsigned iter = 40;
+
+    std::uniform_int_distribution<int> randWeight(-50, 50);
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(1, 80, i%2 ? 0.2 : 0.02, 0, 0);
+        unsigned n = graph.size();
+        for(auto &j : graph.getEdges()) graph(j[0], j[1]) = randWeight(mt);
+
+        //reference: Prim over the lightest edge of every pair, started in every tree
+        const long long none = std::numeric_limits<long long>::max();
+        std::vector<std::vector<long long>> pairWeight(n, std::vector<long long>(n, none));
+        for(auto &j : graph.getEdges())
+        {
+            if(j[0]==j[1]) continue;
+            long long w = graph(j[0], j[1]);
+            pairWeight[j[0]][j[1]] = pairWeight[j[1]][j[0]] = std::min(pairWeight[j[0]][j[1]], w);
+        }
+        long long expectedWeight = 0;
+        unsigned trees = 0;
+        std::vector<bool> inTree(n, false);
+        std::vector<long long> distance(n, none);
+        for(unsigned start=0; start<n; start++)
+        {
+            if(inTree[start]) continue;
+            trees++;
+            distance[start] = 0;
+            while(true)
+            {
+                unsigned curr = n;
+                for(unsigned v=0; v<n; v++)
+                {
+                    if(!inTree[v] && distance[v]!=none && (curr==n || distance[v]<distance[curr])) curr = v;
+                }
+                if(curr==n) break;
+                inTree[curr] = true;
+                expectedWeight += distance[curr];
+                for(unsigned v=0; v<n; v++)
+                {
+                    if(!inTree[v]) distance[v] = std::min(distance[v], pairWeight[curr][v]);
+                }
+            }
+        }
+
+        auto weight = [](int data){ return data; };
+        std::vector<SpanningEdge> kruskal = minimumSpanningForest(graph, weight);
+        std::vector<SpanningEdge> boruvka = parallelMinimumSpanningForest(graph, weight);
+        ASSERT_EQ(kruskal.size(), n-trees);
+        ASSERT_EQ(boruvka.size(), n-trees);
+        long long total = 0;
+        DisjointSets sets(n);
+        for(auto &j : kruskal)
+        {
+            ASSERT_TRUE(sets.unite(j.from, j.to));
+            total += graph(j.from, j.to);
+        }
+        ASSERT_EQ(total, expectedWeight);
+
+        //unique minimum (ties broken by edge order), so both algorithms choose the same edges
+        auto sorted = [](std::vector<SpanningEdge> edges)
+        {
+            std::vector<std::pair<unsigned, unsigned>> res;
+            for(auto &j : edges) res.push_back({j.from, j.to});
+            std::sort(res.begin(), res.end());
+            return res;
+        };
+        ASSERT_EQ(sorted(kruskal), sorted(boruvka));
+
+        //floating point keys of matrix edges
+        MatrixGraph<int, int> matrix(graph);
+        total = 0;
+        for(auto &j : parallelMinimumSpanningForest(matrix, [](int data){ return data/10.0; })) total += graph(j.from, j.to);
+        ASSERT_EQ(total, expectedWeight);
+    }
+}
+
+TEST(Graph, TestTopologicalOrder)
+{
+    unsigned iter = 100;
+
+    std::uniform_int_distribution<unsigned> randInt(0, 1000);
+    for(unsigned i=0; i<iter; i++)
+    {
+        //random DAG: edges go from smaller to larger hidden ranks
+        unsigned n = randInt(mt)%80+1;
+        std::vector<unsigned> rank(n);
+        for(unsigned j=0; j<n; j++) rank[j] = j;
+        std::shuffle(rank.begin(), rank.end(), mt);
+        ListGraph<int, int> graph;
+        for(unsigned j=0; j<n; j++) graph.addVertex(0);
+        for(unsigned a=0; a<n; a++)
+        {
+            for(unsigned b=0; b<n; b++)
+            {
+                if(rank[a]<rank[b] && randInt(mt)%20==0) graph.addEdge(a, b, 0);
+            }
+        }
+
+        std::vector<unsigned> order, cycle;
+        ASSERT_TRUE(topologicalOrder(graph, order, &cycle));
+        ASSERT_TRUE(cycle.empty());
+        ASSERT_TRUE(findCycle(graph).empty());
+        ASSERT_EQ(order.size(), n);
+        std::vector<unsigned> position(n);
+        for(unsigned j=0; j<n; j++) position[order[j]] = j;
+        for(auto &j : graph.getEdges()) ASSERT_LT(position[j[0]], position[j[1]]);
+
+        std::vector<std::vector<unsigned>> levels;
+        ASSERT_TRUE(topologicalLevels(graph, levels));
+        std::vector<unsigned> level(n, n);
+        unsigned placed = 0;
+        for(unsigned j=0; j<levels.size(); j++)
+        {
+            for(unsigned v : levels[j]) level[v] = j;
+            placed += levels[j].size();
+        }
+        ASSERT_EQ(placed, n);
+        //every vertex is exactly one level after its latest predecessor
+        std::vector<unsigned> expectedLevel(n, 0);
+        for(unsigned v : order) graph.forEachOut(v, [&](unsigned u){ expectedLevel[u] = std::max(expectedLevel[u], expectedLevel[v]+1); });
+        ASSERT_EQ(level, expectedLevel);
+
+        //closing edge makes a cycle which is reported
+        if(n<2) continue;
+        unsigned from = order.back(), to = order[randInt(mt)%(n-1)];
+        if(!graph.isEdgeExists(from, to)) graph.addEdge(from, to, 0);
+        if(graph.getPathLength(to, from)==0) continue; //edge to an unrelated vertex
+        ASSERT_FALSE(topologicalOrder(graph, order, &cycle));
+        ASSERT_FALSE(topologicalLevels(graph, levels));
+        ASSERT_LT(order.size(), n);
+        ASSERT_GE(cycle.size(), 2u);
+        for(unsigned j=0; j<cycle.size(); j++) ASSERT_TRUE(graph.isEdgeExists(cycle[j], cycle[(j+1)%cycle.size()]));
+        ASSERT_FALSE(findCycle(MatrixGraph<int, int>(graph)).empty());
+    }
+
+    ListGraph<int, int> loop;
+    loop.addVertex(0);
+    loop.addEdge(0, 0, 0);
+    ASSERT_EQ(findCycle(loop), std::vector<unsigned>{0});
+}
+
+TEST(Graph, TestDiameter)
+{
+    unsigned iter = 60;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(1, 120, i%3 ? 0.02 : 0.2, 0, 0);
+        unsigned n = graph.size();
+
+        //reference: BFS from every vertex over undirected edges
+        UndirectedArrays neighbours = undirectedArrays(graph);
+        std::vector<unsigned> eccentricity(n, 0);
+        for(unsigned v=0; v<n; v++)
+        {
+            auto cursor = breadthFirstCursor(neighbours, v);
+            for(const TraversalStep &step : cursor) eccentricity[v] = std::max(eccentricity[v], step.depth);
+        }
+        unsigned expected = *std::max_element(eccentricity.begin(), eccentricity.end());
+        ASSERT_EQ(diameter(graph), expected);
+        ASSERT_EQ(diameter(MatrixGraph<int, int>(graph)), expected);
+        for(unsigned budget : {0u, 1u, 10u})
+        {
+            DiameterBounds bounds = diameterBounds(graph, budget);
+            ASSERT_LE(bounds.lower, expected);
+            ASSERT_GE(bounds.upper, expected);
+        }
+
+        std::vector<unsigned> estimate = estimateEccentricities(graph, 8, mt);
+        unsigned exact = 0;
+        for(unsigned v=0; v<n; v++)
+        {
+            ASSERT_LE(estimate[v], eccentricity[v]);
+            if(estimate[v]==eccentricity[v]) exact++;
+        }
+        ASSERT_GE(exact, std::min(n, 8u)); //at least sources are exact
+    }
+
+    //long path: the bound stops the search after a few levels
+    ListGraph<int, int> path;
+    for(unsigned i=0; i<1000; i++) path.addVertex(0);
+    for(unsigned i=0; i+1<1000; i++) path.addEdge(i+1, i, 0);
+    ASSERT_EQ(diameter(path), 999u);
+}
+
+TEST(Graph, TestBetweenness)
+{
+    unsigned iter = 30;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(1, 50, i%2 ? 0.05 : 0.15, 0, 0);
+        unsigned n = graph.size();
+
+        //reference: v is on a shortest s-t path if d(s,v)+d(v,t)==d(s,t), with paths(s,v)*paths(v,t) of them
+        const unsigned none = std::numeric_limits<unsigned>::max();
+        std::vector<std::vector<unsigned>> dist(n, std::vector<unsigned>(n, none));
+        std::vector<std::vector<double>> paths(n, std::vector<double>(n, 0));
+        for(unsigned s=0; s<n; s++)
+        {
+            dist[s][s] = 0;
+            paths[s][s] = 1;
+            auto cursor = breadthFirstCursor(graph, s);
+            std::vector<unsigned> order;
+            for(const TraversalStep &step : cursor)
+            {
+                dist[s][step.vertex] = step.depth;
+                order.push_back(step.vertex);
+            }
+            for(unsigned v : order)
+            {
+                graph.forEachOut(v, [&](unsigned w){ if(dist[s][w]==dist[s][v]+1) paths[s][w] += paths[s][v]; });
+            }
+        }
+        std::vector<double> expected(n, 0);
+        for(unsigned s=0; s<n; s++)
+        {
+            for(unsigned t=0; t<n; t++)
+            {
+                if(s==t || dist[s][t]==none) continue;
+                for(unsigned v=0; v<n; v++)
+                {
+                    if(v==s || v==t || dist[s][v]==none || dist[v][t]==none) continue;
+                    if(dist[s][v]+dist[v][t]==dist[s][t]) expected[v] += paths[s][v]*paths[v][t]/paths[s][t];
+                }
+            }
+        }
+
+        std::vector<double> centrality = betweenness(graph);
+        std::vector<double> matrixCentrality = betweenness(MatrixGraph<int, int>(graph));
+        std::vector<double> sampled = sampledBetweenness(graph, n, mt); //every source is taken
+        for(unsigned v=0; v<n; v++)
+        {
+            ASSERT_NEAR(centrality[v], expected[v], 1e-9);
+            ASSERT_NEAR(matrixCentrality[v], expected[v], 1e-9);
+            ASSERT_NEAR(sampled[v], expected[v], 1e-9);
+        }
+    }
+
+    //path a-->b-->c: only b is between
+    ListGraph<int, int> path;
+    for(unsigned i=0; i<3; i++) path.addVertex(0);
+    path.addEdge(0, 1, 0);
+    path.addEdge(1, 2, 0);
+    ASSERT_EQ(betweenness(path), (std::vector<double>{0, 1, 0}));
+    std::vector<double> estimate = sampledBetweenness(path, 1, mt);
+    ASSERT_TRUE(estimate[1]==0 || estimate[1]==3); //only the source 0 sees b in the middle
+}
+
+TEST(Graph, TestMaxFlow)
+{
+    unsigned iter = 100;
+
+    std::uniform_int_distribution<int> randCapacity(0, 20);
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(2, 40, i%2 ? 0.1 : 0.3, 0, 0);
+        unsigned n = graph.size();
+        for(auto &j : graph.getEdges()) graph(j[0], j[1]) = randCapacity(mt);
+        unsigned source = 0, sink = n-1;
+
+        //reference: Edmonds-Karp over the capacity matrix
+        std::vector<std::vector<long long>> rest(n, std::vector<long long>(n, 0));
+        for(auto &j : graph.getEdges())
+        {
+            if(j[0]!=j[1]) rest[j[0]][j[1]] += graph(j[0], j[1]);
+        }
+        long long expected = 0;
+        while(true)
+        {
+            std::vector<unsigned> prev(n, n);
+            std::vector<unsigned> queue{source};
+            prev[source] = source;
+            for(unsigned head=0; head<queue.size(); head++)
+            {
+                for(unsigned u=0; u<n; u++)
+                {
+                    if(prev[u]==n && rest[queue[head]][u]>0)
+                    {
+                        prev[u] = queue[head];
+                        queue.push_back(u);
+                    }
+                }
+            }
+            if(prev[sink]==n) break;
+            long long delta = std::numeric_limits<long long>::max();
+            for(unsigned v=sink; v!=source; v=prev[v]) delta = std::min(delta, rest[prev[v]][v]);
+            for(unsigned v=sink; v!=source; v=prev[v])
+            {
+                rest[prev[v]][v] -= delta;
+                rest[v][prev[v]] += delta;
+            }
+            expected += delta;
+        }
+
+        auto capacity = [](int data){ return (long long)data; };
+        FlowResult<long long> flow = maxFlow(graph, source, sink, capacity);
+        ASSERT_EQ(flow.value, expected);
+        ASSERT_EQ(maxFlow(MatrixGraph<int, int>(graph), source, sink, capacity).value, expected);
+
+        //capacity of the cut is equal to the flow
+        ASSERT_TRUE(flow.sourceSide[source]);
+        ASSERT_FALSE(flow.sourceSide[sink]);
+        long long cut = 0;
+        for(auto &j : graph.getEdges())
+        {
+            if(flow.sourceSide[j[0]] && !flow.sourceSide[j[1]]) cut += graph(j[0], j[1]);
+        }
+        ASSERT_EQ(cut, expected);
+    }
+}
+
+TEST(Graph, TestColoring)
+{
+    unsigned iter = 40;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(1, 150, i%2 ? 0.3 : 0.03, 0, 0);
+        unsigned n = graph.size();
+        std::vector<unsigned> cores = coreNumbers(graph);
+        unsigned degeneracy = *std::max_element(cores.begin(), cores.end());
+        unsigned maxDegree = 0;
+        UndirectedArrays neighbours = undirectedArrays(graph);
+        for(unsigned v=0; v<n; v++) maxDegree = std::max(maxDegree, neighbours.offsets[v+1]-neighbours.offsets[v]);
+
+        auto check = [&](const std::vector<unsigned> &color, unsigned colorsLimit)
+        {
+            ASSERT_EQ(color.size(), n);
+            for(auto &j : graph.getEdges())
+            {
+                ASSERT_TRUE(j[0]==j[1] || color[j[0]]!=color[j[1]]);
+            }
+            ASSERT_LT(*std::max_element(color.begin(), color.end()), colorsLimit);
+        };
+        check(greedyColoring(graph, ColoringOrder::smallestLast), degeneracy+1);
+        check(greedyColoring(MatrixGraph<int, int>(graph), ColoringOrder::largestFirst), maxDegree+1);
+        check(parallelColoring(graph), maxDegree+1);
+    }
+
+    //complete graph needs a color per vertex, a star only 2
+    ListGraph<int, int> complete, star;
+    for(unsigned i=0; i<10; i++)
+    {
+        complete.addVertex(0);
+        star.addVertex(0);
+    }
+    for(unsigned i=0; i<10; i++)
+    {
+        for(unsigned j=0; j<10; j++)
+        {
+            if(i!=j) complete.addEdge(i, j, 0);
+        }
+        if(i>0) star.addEdge(0, i, 0);
+    }
+    std::vector<unsigned> color = greedyColoring(complete);
+    std::sort(color.begin(), color.end());
+    ASSERT_EQ(color, (std::vector<unsigned>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    color = greedyColoring(star);
+    ASSERT_EQ(*std::max_element(color.begin(), color.end()), 1u);
+}
+
+TEST(Graph, TestQueryExecutor)
+{
+    unsigned iter = 10;
+
+    for(unsigned i=0; i<iter; i++)
+    {
+        ListGraph<int, int> graph;
+        graph.randomGraph(2, 200, i%2 ? 0.02 : 0.005, 0, 0);
+        unsigned n = graph.size();
+        unsigned long long submitted = 0;
+        std::vector<std::future<std::vector<unsigned>>> routes;
+        std::vector<std::future<unsigned>> lengths, counts;
+        std::vector<std::pair<unsigned, unsigned>> pairs;
+        {
+            QueryExecutor<ListGraph<int, int>> executor(graph, 1+i%4);
+            //few sources, so waiting queries are often answered by one search
+            for(unsigned j=0; j<300; j++)
+            {
+                unsigned from = j%7%n, to = (j*31+i)%n;
+                if(from==to) continue;
+                pairs.emplace_back(from, to);
+                routes.push_back(executor.path(from, to));
+                lengths.push_back(executor.pathLength(from, to));
+                counts.push_back(executor.reachedCount(from));
+                submitted += 3;
+            }
+            for(unsigned j=0; j<pairs.size(); j++)
+            {
+                unsigned from = pairs[j].first, to = pairs[j].second;
+                ASSERT_EQ(routes[j].get(), pathVertices(graph, from, to));
+                ASSERT_EQ(lengths[j].get(), pathLength(graph, from, to));
+                ASSERT_EQ(counts[j].get(), reachedCount(graph, from));
+            }
+            //answers are counted right after their futures are made ready
+            while(executor.stats().completed<submitted) std::this_thread::yield();
+            QueryStats stats = executor.stats();
+            ASSERT_EQ(executor.queueDepth(), 0);
+            ASSERT_EQ(stats.completed, submitted);
+            ASSERT_LE(stats.searches, stats.completed);
+            ASSERT_LE(stats.p50, stats.p90);
+            ASSERT_LE(stats.p90, stats.p99);
+        }
+    }
+
+    //queries submitted right before destruction are still answered
+    ListGraph<int, int> path;
+    for(unsigned i=0; i<50; i++) path.addVertex(0);
+    for(unsigned i=0; i+1<50; i++) path.addEdge(i, i+1, 0);
+    std::future<unsigned> length, count;
+    {
+        QueryExecutor<ListGraph<int, int>> executor(path, 2);
+        length = executor.pathLength(0, 49);
+        count = executor.reachedCount(10);
+    }
+    ASSERT_EQ(length.get(), 49);
+    ASSERT_EQ(count.get(), 40);
+}